@@ -0,0 +1,119 @@
+//============================================================================
+// Allocation audit
+// -DALLOC_AUDIT replaces the global operator new/delete with versions that
+// count allocations and bytes, per process and per thread. AllocScope
+// reports what a stretch of work allocated (each go, perft, tuner iteration
+// and datagen game); in other builds it compiles to nothing. Adding
+// -DALLOC_AUDIT_ASSERT makes any allocation inside a NoAllocScope (the
+// search after its first iteration) print the size and abort.
+//
+// Included from thisbot.cpp outside the per-ISA engine namespaces: there is
+// one operator new per program, however many engine copies it holds.
+//============================================================================
+#if defined(ALLOC_AUDIT_ASSERT) && !defined(ALLOC_AUDIT)
+#define ALLOC_AUDIT
+#endif
+
+struct AllocCount {
+    std::uint64_t allocs = 0;
+    std::uint64_t bytes = 0;
+};
+
+#if defined(ALLOC_AUDIT)
+
+namespace alloc_audit {
+inline std::atomic<std::uint64_t> allocs{0};
+inline std::atomic<std::uint64_t> bytes{0};
+inline thread_local AllocCount thread;
+inline thread_local int forbidden = 0;  // NoAllocScope nesting on this thread
+
+inline void* allocate(std::size_t size, std::size_t align) {
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    ++thread.allocs;
+    thread.bytes += size;
+#if defined(ALLOC_AUDIT_ASSERT)
+    if (forbidden > 0) {
+        forbidden = 0;  // The message itself may allocate
+        std::cerr << "alloc audit: " << size << "-byte allocation in a no-allocation scope" << std::endl;
+        std::abort();
+    }
+#endif
+    void* p = nullptr;
+    if (align <= alignof(std::max_align_t)) p = std::malloc(size ? size : 1);
+    else p = std::aligned_alloc(align, std::max<std::size_t>(1, (size + align - 1) / align) * align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+} // namespace alloc_audit
+
+void* operator new(std::size_t size) { return alloc_audit::allocate(size, 0); }
+void* operator new[](std::size_t size) { return alloc_audit::allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) { return alloc_audit::allocate(size, std::size_t(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return alloc_audit::allocate(size, std::size_t(al)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Counts since construction, on this thread or (allThreads) in the process
+class AllocScope {
+public:
+    explicit AllocScope(bool allThreads = false) : all_(allThreads), start_(now()) {}
+
+    AllocCount delta() const {
+        AllocCount c = now();
+        return { c.allocs - start_.allocs, c.bytes - start_.bytes };
+    }
+
+    // "<prefix>alloc <what> [index]: N allocations, B bytes" as one write
+    void report(std::ostream& out, const char* prefix, const char* what, int index = -1) const {
+        AllocCount d = delta();
+        std::ostringstream line;
+        line << prefix << "alloc " << what;
+        if (index >= 0) line << " " << index;
+        line << ": " << d.allocs << " allocations, " << d.bytes << " bytes\n";
+        out << line.str() << std::flush;
+    }
+
+private:
+    bool all_;
+    AllocCount start_;
+
+    AllocCount now() const {
+        if (!all_) return alloc_audit::thread;
+        return { alloc_audit::allocs.load(std::memory_order_relaxed),
+                 alloc_audit::bytes.load(std::memory_order_relaxed) };
+    }
+};
+
+class NoAllocScope {
+public:
+    explicit NoAllocScope(bool active = true) : active_(active) { if (active_) ++alloc_audit::forbidden; }
+    ~NoAllocScope() { if (active_ && alloc_audit::forbidden > 0) --alloc_audit::forbidden; }
+    NoAllocScope(const NoAllocScope&) = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+private:
+    bool active_;
+};
+
+#else
+
+class AllocScope {
+public:
+    explicit AllocScope(bool = false) {}
+    AllocCount delta() const { return {}; }
+    void report(std::ostream&, const char*, const char*, int = -1) const {}
+};
+
+class NoAllocScope {
+public:
+    explicit NoAllocScope(bool = true) {}
+};
+
+#endif
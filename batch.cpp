@@ -0,0 +1,321 @@
+namespace chess {
+
+//============================================================================
+// OPTIMIZATION 13: Structure-of-arrays board batch
+//============================================================================
+// BoardBatch keeps BATCH_LANES positions side by side (one array per piece
+// kind, one slot per position) and counts the legal moves of all of them in
+// one pass. Each lane is stored from its side to move's point of view, black
+// to move mirrored vertically, so the count is a single branch-free stream of
+// shifts and masks for every lane. Sliders use Kogge-Stone fills rather than
+// table lookups, which would need gathers. With GCC/clang a LaneBB is one
+// AVX2 register, or a pair of SSE2 registers on targets without AVX (where a
+// 32-byte vector type would change the calling convention).
+//
+// Its one user is perft, which counts depth-1 leaves with it; search and
+// make/unmake stay on Board.
+constexpr int BATCH_LANES = 4;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__AVX2__) || defined(ENGINE_TARGET_BMI2))
+typedef Bitboard LaneBB __attribute__((vector_size(BATCH_LANES * sizeof(Bitboard))));
+
+FORCE_INLINE LaneBB splat(Bitboard b) { return LaneBB{} | b; }
+FORCE_INLINE LaneBB isZero(LaneBB v) { return (LaneBB)(v == LaneBB{}); }
+FORCE_INLINE LaneBB nonZero(LaneBB v) { return (LaneBB)(v != LaneBB{}); }
+#elif defined(__GNUC__) || defined(__clang__)
+// Lanes 0-1 in lo, 2-3 in hi
+typedef Bitboard LaneHalf __attribute__((vector_size(2 * sizeof(Bitboard))));
+struct LaneBB {
+    LaneHalf lo, hi;
+    FORCE_INLINE Bitboard operator[](int i) const { return i < 2 ? lo[i] : hi[i - 2]; }
+    FORCE_INLINE LaneBB operator~() const { return {~lo, ~hi}; }
+    FORCE_INLINE LaneBB operator<<(int n) const { return {lo << n, hi << n}; }
+    FORCE_INLINE LaneBB operator>>(int n) const { return {lo >> n, hi >> n}; }
+#define LANE_OP(op) \
+    friend FORCE_INLINE LaneBB operator op(const LaneBB& a, const LaneBB& b) { return {a.lo op b.lo, a.hi op b.hi}; } \
+    friend FORCE_INLINE LaneBB operator op(const LaneBB& a, Bitboard b) { return {a.lo op b, a.hi op b}; } \
+    friend FORCE_INLINE LaneBB& operator op##=(LaneBB& a, const LaneBB& b) { return a = a op b; } \
+    friend FORCE_INLINE LaneBB& operator op##=(LaneBB& a, Bitboard b) { return a = a op b; }
+    LANE_OP(&) LANE_OP(|) LANE_OP(^) LANE_OP(+) LANE_OP(-)
+#undef LANE_OP
+};
+
+FORCE_INLINE LaneBB splat(Bitboard b) { return {LaneHalf{} | b, LaneHalf{} | b}; }
+FORCE_INLINE LaneBB isZero(const LaneBB& v) { return {(LaneHalf)(v.lo == LaneHalf{}), (LaneHalf)(v.hi == LaneHalf{})}; }
+FORCE_INLINE LaneBB nonZero(const LaneBB& v) { return ~isZero(v); }
+#else
+// Portable stand-in; compilers without vector extensions still auto-vectorize
+// most of these loops
+struct LaneBB {
+    Bitboard v[BATCH_LANES];
+    FORCE_INLINE Bitboard& operator[](int i) { return v[i]; }
+    FORCE_INLINE Bitboard operator[](int i) const { return v[i]; }
+    FORCE_INLINE LaneBB operator~() const { LaneBB r; for (int i = 0; i < BATCH_LANES; i++) r.v[i] = ~v[i]; return r; }
+    FORCE_INLINE LaneBB operator<<(int n) const { LaneBB r; for (int i = 0; i < BATCH_LANES; i++) r.v[i] = v[i] << n; return r; }
+    FORCE_INLINE LaneBB operator>>(int n) const { LaneBB r; for (int i = 0; i < BATCH_LANES; i++) r.v[i] = v[i] >> n; return r; }
+#define LANE_OP(op) \
+    friend FORCE_INLINE LaneBB operator op(LaneBB a, LaneBB b) { for (int i = 0; i < BATCH_LANES; i++) a.v[i] = a.v[i] op b.v[i]; return a; } \
+    friend FORCE_INLINE LaneBB operator op(LaneBB a, Bitboard b) { for (int i = 0; i < BATCH_LANES; i++) a.v[i] = a.v[i] op b; return a; } \
+    friend FORCE_INLINE LaneBB& operator op##=(LaneBB& a, LaneBB b) { return a = a op b; } \
+    friend FORCE_INLINE LaneBB& operator op##=(LaneBB& a, Bitboard b) { return a = a op b; }
+    LANE_OP(&) LANE_OP(|) LANE_OP(^) LANE_OP(+) LANE_OP(-)
+#undef LANE_OP
+};
+
+FORCE_INLINE LaneBB splat(Bitboard b) { LaneBB r; for (int i = 0; i < BATCH_LANES; i++) r.v[i] = b; return r; }
+FORCE_INLINE LaneBB isZero(LaneBB v) { LaneBB r; for (int i = 0; i < BATCH_LANES; i++) r.v[i] = v.v[i] ? 0 : ~0ULL; return r; }
+FORCE_INLINE LaneBB nonZero(LaneBB v) { return ~isZero(v); }
+#endif
+
+namespace Batch {
+
+// One step in direction D with the same wrap masks as the Kogge-Stone fills
+template<int D>
+FORCE_INLINE LaneBB step(LaneBB b) {
+    constexpr Bitboard wrap = (D == 1 || D == NORTH_EAST || D == SOUTH_EAST) ? NOT_FILE_A
+                            : (D == -1 || D == NORTH_WEST || D == SOUTH_WEST) ? NOT_FILE_H : ~0ULL;
+    return (D > 0 ? b << D : b >> -D) & wrap;
+}
+
+// One knight jump by square offset D; the mask drops jumps that left the board sideways
+template<int D>
+FORCE_INLINE LaneBB knightStep(LaneBB b) {
+    constexpr Bitboard wrap = (D == 17 || D == -15) ? NOT_FILE_A
+                            : (D == 15 || D == -17) ? NOT_FILE_H
+                            : (D == 10 || D == -6) ? NOT_FILE_A & ~(FILE_A << 1)
+                            : NOT_FILE_H & ~(FILE_A << 6);
+    return (D > 0 ? b << D : b >> -D) & wrap;
+}
+
+FORCE_INLINE LaneBB kingAttacks(LaneBB k) {
+    return step<NORTH>(k) | step<SOUTH>(k) | step<1>(k) | step<-1>(k)
+         | step<NORTH_EAST>(k) | step<NORTH_WEST>(k) | step<SOUTH_EAST>(k) | step<SOUTH_WEST>(k);
+}
+
+FORCE_INLINE LaneBB knightAttacks(LaneBB n) {
+    return knightStep<17>(n) | knightStep<15>(n) | knightStep<10>(n) | knightStep<6>(n)
+         | knightStep<-6>(n) | knightStep<-10>(n) | knightStep<-15>(n) | knightStep<-17>(n);
+}
+
+// Per-byte population counts (0..8 in each byte). Summing these instead of
+// full popcounts keeps the count in vector registers; a byte (one rank) never
+// collects more than the 218 moves a position can have.
+FORCE_INLINE LaneBB bytePopCount(LaneBB x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    return (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+FORCE_INLINE LaneBB byteSum(LaneBB x) {
+    x = (x & 0x00FF00FF00FF00FFULL) + ((x >> 8) & 0x00FF00FF00FF00FFULL);
+    x = (x & 0x0000FFFF0000FFFFULL) + ((x >> 16) & 0x0000FFFF0000FFFFULL);
+    return (x & 0xFFFFFFFFULL) + (x >> 32);
+}
+
+// Pawn moves to the last rank count once per promotion piece
+FORCE_INLINE LaneBB pawnMoveCount(LaneBB to) {
+    return bytePopCount(to & ~RANK_8) + (bytePopCount(to & RANK_8) << 2);
+}
+
+template<int D>
+FORCE_INLINE LaneBB ray(LaneBB gen, LaneBB empty) { return Sliders::KoggeStone::ray<D>(gen, empty); }
+
+FORCE_INLINE LaneBB rookRays(LaneBB gen, LaneBB empty) {
+    return ray<NORTH>(gen, empty) | ray<SOUTH>(gen, empty) | ray<1>(gen, empty) | ray<-1>(gen, empty);
+}
+
+FORCE_INLINE LaneBB bishopRays(LaneBB gen, LaneBB empty) {
+    return ray<NORTH_EAST>(gen, empty) | ray<NORTH_WEST>(gen, empty)
+         | ray<SOUTH_EAST>(gen, empty) | ray<SOUTH_WEST>(gen, empty);
+}
+
+FORCE_INLINE Bitboard byteSwap(Bitboard b) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(b);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(b);
+#else
+    b = ((b >> 8) & 0x00FF00FF00FF00FFULL) | ((b & 0x00FF00FF00FF00FFULL) << 8);
+    b = ((b >> 16) & 0x0000FFFF0000FFFFULL) | ((b & 0x0000FFFF0000FFFFULL) << 16);
+    return (b >> 32) | (b << 32);
+#endif
+}
+
+} // namespace Batch
+
+class BoardBatch {
+public:
+    static constexpr int LANES = BATCH_LANES;
+
+    // [piece type][lane]; "us" is the side to move in that lane
+    alignas(32) Bitboard us_[6][LANES]{};
+    alignas(32) Bitboard them_[6][LANES]{};
+    alignas(32) Bitboard ep_[LANES]{};      // En passant target square, or 0
+    alignas(32) Bitboard castle_[LANES]{};  // King destinations still allowed: G1 and/or C1
+    int size_ = 0;
+
+    FORCE_INLINE int size() const { return size_; }
+    FORCE_INLINE bool full() const { return size_ == LANES; }
+    FORCE_INLINE void clear() { size_ = 0; }
+
+    // Copy a position into the next lane. Lanes past size() keep old, valid
+    // positions, so a partial batch is counted like a full one.
+    void push(const Board& b) {
+        assert(size_ < LANES);
+        int lane = size_++;
+        Color us = b.sideToMove_, them = ~us;
+        auto orient = [us](Bitboard x) { return us == WHITE ? x : Batch::byteSwap(x); };
+
+        for (int pt = PAWN; pt <= KING; pt++) {
+            us_[pt][lane] = orient(b.pieces_[us][pt]);
+            them_[pt][lane] = orient(b.pieces_[them][pt]);
+        }
+        ep_[lane] = b.epSquare_ >= 0 ? orient(squareBB(b.epSquare_)) : 0;
+        CastlingRights oo = us == WHITE ? WHITE_OO : BLACK_OO;
+        CastlingRights ooo = us == WHITE ? WHITE_OOO : BLACK_OOO;
+        castle_[lane] = ((b.castling_ & oo) ? squareBB(6) : 0) | ((b.castling_ & ooo) ? squareBB(2) : 0);
+    }
+
+    // Legal move count of every lane into out[0..LANES)
+    void legalMoveCounts(int* out) const {
+        using namespace Batch;
+        const LaneBB P = load(us_[PAWN]), N = load(us_[KNIGHT]), B = load(us_[BISHOP]);
+        const LaneBB R = load(us_[ROOK]), Q = load(us_[QUEEN]), K = load(us_[KING]);
+        const LaneBB tP = load(them_[PAWN]), tN = load(them_[KNIGHT]), tB = load(them_[BISHOP]);
+        const LaneBB tR = load(them_[ROOK]), tQ = load(them_[QUEEN]), tK = load(them_[KING]);
+
+        const LaneBB own = P | N | B | R | Q | K;
+        const LaneBB enemy = tP | tN | tB | tR | tQ | tK;
+        const LaneBB occ = own | enemy, empty = ~occ;
+        const LaneBB rq = tR | tQ, bq = tB | tQ;
+
+        // Enemy attacks with our king lifted off the board, so stepping back
+        // along a checking ray is seen as attacked
+        const LaneBB thru = empty | K;
+        const LaneBB attacked = step<SOUTH_EAST>(tP) | step<SOUTH_WEST>(tP)
+                              | knightAttacks(tN) | kingAttacks(tK)
+                              | rookRays(rq, thru) | bishopRays(bq, thru);
+
+        // Checkers, check-blocking rays and pins, one king ray per direction.
+        // pinAxis[a]: our pieces pinned along axis a (file, rank, a1-h8, h1-a8).
+        LaneBB checkers = (step<NORTH_EAST>(K) | step<NORTH_WEST>(K)) & tP;
+        checkers |= knightAttacks(K) & tN;
+        LaneBB checkRays = checkers;
+        LaneBB pinAxis[4] = {};
+        auto kingRay = [&](auto dir, int axis) {
+            constexpr int D = decltype(dir)::value;
+            const LaneBB snipers = (D == NORTH || D == SOUTH || D == 1 || D == -1) ? rq : bq;
+            LaneBB r = ray<D>(K, empty);
+            LaneBB hit = r & snipers;
+            checkers |= hit;
+            checkRays |= r & nonZero(hit);
+            LaneBB blocker = r & own;
+            LaneBB xray = ray<D>(K, empty | blocker);
+            pinAxis[axis] |= blocker & nonZero(xray & snipers);
+        };
+        kingRay(std::integral_constant<int, NORTH>{}, 0);
+        kingRay(std::integral_constant<int, SOUTH>{}, 0);
+        kingRay(std::integral_constant<int, 1>{}, 1);
+        kingRay(std::integral_constant<int, -1>{}, 1);
+        kingRay(std::integral_constant<int, NORTH_EAST>{}, 2);
+        kingRay(std::integral_constant<int, SOUTH_WEST>{}, 2);
+        kingRay(std::integral_constant<int, NORTH_WEST>{}, 3);
+        kingRay(std::integral_constant<int, SOUTH_EAST>{}, 3);
+
+        const LaneBB notChecked = isZero(checkers);
+        const LaneBB singleCheck = isZero(checkers & (checkers - 1));  // zero or one checker
+        const LaneBB target = ~own & (notChecked | checkRays) & singleCheck;
+        const LaneBB pinned = pinAxis[0] | pinAxis[1] | pinAxis[2] | pinAxis[3];
+        const LaneBB free = ~pinned;
+
+        // King
+        LaneBB count = bytePopCount(kingAttacks(K) & ~own & ~attacked);
+
+        // Knights: a pinned knight never moves. Counting each jump direction
+        // separately counts every (knight, square) pair once.
+        const LaneBB n = N & free;
+        count += bytePopCount(knightStep<17>(n) & target) + bytePopCount(knightStep<15>(n) & target)
+               + bytePopCount(knightStep<10>(n) & target) + bytePopCount(knightStep<6>(n) & target)
+               + bytePopCount(knightStep<-6>(n) & target) + bytePopCount(knightStep<-10>(n) & target)
+               + bytePopCount(knightStep<-15>(n) & target) + bytePopCount(knightStep<-17>(n) & target);
+
+        // Sliders: within one direction the fills of different sliders never
+        // overlap (each stops at the next piece), so per-direction counts add
+        // up exactly. Pinned sliders move only along their pin axis, where the
+        // fill is bounded by our king and the pinner.
+        const LaneBB orth = R | Q, diag = B | Q;
+        auto slide = [&](auto dir, int axis) {
+            constexpr int D = decltype(dir)::value;
+            LaneBB movers = ((D == NORTH || D == SOUTH || D == 1 || D == -1) ? orth : diag) & (free | pinAxis[axis]);
+            count += bytePopCount(ray<D>(movers, empty) & target);
+        };
+        slide(std::integral_constant<int, NORTH>{}, 0);
+        slide(std::integral_constant<int, SOUTH>{}, 0);
+        slide(std::integral_constant<int, 1>{}, 1);
+        slide(std::integral_constant<int, -1>{}, 1);
+        slide(std::integral_constant<int, NORTH_EAST>{}, 2);
+        slide(std::integral_constant<int, SOUTH_WEST>{}, 2);
+        slide(std::integral_constant<int, NORTH_WEST>{}, 3);
+        slide(std::integral_constant<int, SOUTH_EAST>{}, 3);
+
+        // Pawns
+        LaneBB single = step<NORTH>(P & (free | pinAxis[0])) & empty;
+        LaneBB dbl = step<NORTH>(single & RANK_3) & empty & target;
+        count += pawnMoveCount(single & target) + bytePopCount(dbl);
+        count += pawnMoveCount(step<NORTH_EAST>(P & (free | pinAxis[2])) & enemy & target);
+        count += pawnMoveCount(step<NORTH_WEST>(P & (free | pinAxis[3])) & enemy & target);
+
+        LaneBB total = byteSum(count);
+
+        // Castling; rights imply king and rook are on their squares
+        const Bitboard F1G1 = squareBB(5) | squareBB(6), B1C1D1 = squareBB(1) | squareBB(2) | squareBB(3);
+        const Bitboard C1D1 = squareBB(2) | squareBB(3);
+        const LaneBB castle = load(castle_);
+        LaneBB oo = nonZero(castle & squareBB(6)) & isZero(occ & F1G1) & isZero(attacked & F1G1);
+        LaneBB ooo = nonZero(castle & squareBB(2)) & isZero(occ & B1C1D1) & isZero(attacked & C1D1);
+        total += ((oo & 1) + (ooo & 1)) & notChecked;
+
+        // En passant: rare, so only when some lane has it. The position after
+        // the capture is checked directly, which covers pins through both pawns
+        // and captures that remove a checking pawn.
+        const LaneBB ep = load(ep_);
+        if (anyLane(ep)) {
+            const LaneBB victim = ep >> 8;
+            auto capture = [&](const LaneBB& from) {
+                LaneBB e = ~((occ ^ from ^ victim) | ep);
+                LaneBB exposed = (rookRays(K, e) & rq) | (bishopRays(K, e) & bq)
+                               | ((step<NORTH_EAST>(K) | step<NORTH_WEST>(K)) & (tP & ~victim))
+                               | (knightAttacks(K) & tN);
+                total += nonZero(from) & isZero(exposed) & 1;
+            };
+            capture(step<SOUTH_WEST>(ep) & P);
+            capture(step<SOUTH_EAST>(ep) & P);
+        }
+
+        for (int i = 0; i < LANES; i++) out[i] = int(total[i]);
+    }
+
+    // Sum of legal move counts over the filled lanes
+    std::uint64_t totalLegalMoves() const {
+        int counts[LANES];
+        legalMoveCounts(counts);
+        std::uint64_t sum = 0;
+        for (int i = 0; i < size_; i++) sum += counts[i];
+        return sum;
+    }
+
+private:
+    static FORCE_INLINE LaneBB load(const Bitboard* lanes) {
+        LaneBB v;
+        std::memcpy(&v, lanes, sizeof v);
+        return v;
+    }
+
+    static FORCE_INLINE bool anyLane(LaneBB v) {
+        Bitboard any = 0;
+        for (int i = 0; i < LANES; i++) any |= v[i];
+        return any != 0;
+    }
+};
+
+} // namespace chess
@@ -69,11 +69,29 @@ constexpr Bitboard FILE_A = 0x0101010101010101ULL;
 constexpr Bitboard FILE_H = FILE_A << 7;
 constexpr Bitboard RANK_1 = 0xFFULL;
 constexpr Bitboard RANK_2 = RANK_1 << 8;
+constexpr Bitboard RANK_3 = RANK_1 << 16;
+constexpr Bitboard RANK_6 = RANK_1 << 40;
 constexpr Bitboard RANK_7 = RANK_1 << 48;
 constexpr Bitboard RANK_8 = RANK_1 << 56;
 constexpr Bitboard NOT_FILE_A = ~FILE_A;
 constexpr Bitboard NOT_FILE_H = ~(FILE_A << 7);
 
+// Square offsets; shift<D> moves a whole set one step without file wrap-around
+constexpr int NORTH = 8, SOUTH = -8;
+constexpr int NORTH_EAST = 9, NORTH_WEST = 7, SOUTH_EAST = -7, SOUTH_WEST = -9;
+
+template<int D>
+FORCE_INLINE constexpr Bitboard shift(Bitboard b) {
+    static_assert(D == NORTH || D == SOUTH || D == NORTH_EAST || D == NORTH_WEST ||
+                  D == SOUTH_EAST || D == SOUTH_WEST, "unsupported shift direction");
+    if constexpr (D == NORTH) return b << 8;
+    else if constexpr (D == SOUTH) return b >> 8;
+    else if constexpr (D == NORTH_EAST) return (b & NOT_FILE_H) << 9;
+    else if constexpr (D == NORTH_WEST) return (b & NOT_FILE_A) << 7;
+    else if constexpr (D == SOUTH_EAST) return (b & NOT_FILE_H) >> 7;
+    else return (b & NOT_FILE_A) >> 9;
+}
+
 //============================================================================
 // OPTIMIZATION 4: Compact enums (uint8_t where possible)
 //============================================================================
@@ -92,32 +110,12 @@ FORCE_INLINE CastlingRights operator&(CastlingRights a, CastlingRights b) { retu
 FORCE_INLINE CastlingRights& operator&=(CastlingRights& a, CastlingRights b) { return a = a & b; }
 
 //============================================================================
-// OPTIMIZATION 5: Compact Move (32-bit instead of struct with padding)
-// Encoding: [from:6][to:6][flags:4][promo:3][captured:3] + padding
+// OPTIMIZATION 5: Compact Move (16 bits, see move.cpp)
+// Encoding: [from:6][to:6][type:2][promo:2]
 //============================================================================
 
 namespace Tables {
 
-alignas(64) Bitboard KING_ATTACKS[64];
-alignas(64) Bitboard KNIGHT_ATTACKS[64];
-alignas(64) Bitboard PAWN_ATTACKS[2][64];
-alignas(64) Bitboard BETWEEN_BB[64][64];
-alignas(64) Bitboard LINE_BB[64][64];
-
-// Magic bitboard tables
-alignas(64) Bitboard ROOK_TABLE[0x19000];
-alignas(64) Bitboard BISHOP_TABLE[0x1480];
-
-struct MagicEntry {
-    Bitboard mask;
-    Bitboard magic;
-    Bitboard* attacks;
-    int shift;
-};
-
-alignas(64) MagicEntry ROOK_MAGICS[64];
-alignas(64) MagicEntry BISHOP_MAGICS[64];
-
 constexpr Bitboard ROOK_MAGIC_NUMBERS[64] = {
     0x80001020804000ULL, 0x640001008200040ULL, 0x680100080200088ULL, 0x480080080b0004cULL,
     0x42800a1400800800ULL, 0x100010002040008ULL, 0x8080020001000080ULL, 0x8100014c29000482ULL,
@@ -176,43 +174,103 @@ constexpr CastlingRights CASTLING_RIGHTS_MASK[64] = {
     CastlingRights(~BLACK_CASTLE), ALL_CASTLING, ALL_CASTLING, CastlingRights(~BLACK_OO)
 };
 
-std::once_flag initFlag;
+//============================================================================
+// OPTIMIZATION: Compile-time tables
+// Everything below is evaluated by the compiler and lands in .rodata: no
+// start-up cost, no init guards, and the pages are shared between processes.
+//============================================================================
+struct Delta { int dr, df; };
+
+constexpr Delta KING_DELTAS[8] = {{-1,-1},{-1,0},{-1,1},{0,-1},{0,1},{1,-1},{1,0},{1,1}};
+constexpr Delta KNIGHT_DELTAS[8] = {{-2,-1},{-2,1},{-1,-2},{-1,2},{1,-2},{1,2},{2,-1},{2,1}};
+constexpr Delta ROOK_DIRS[4] = {{1,0},{-1,0},{0,1},{0,-1}};
+constexpr Delta BISHOP_DIRS[4] = {{1,1},{-1,-1},{1,-1},{-1,1}};
+
+constexpr bool onBoard(int r, int f) { return r >= 0 && r < 8 && f >= 0 && f < 8; }
 
-Bitboard slowRookAttacks(int sq, Bitboard occ) {
+constexpr int constPopCount(Bitboard b) {
+    int n = 0;
+    for (; b; b &= b - 1) ++n;
+    return n;
+}
+
+template<std::size_t N>
+constexpr Bitboard stepAttacks(int sq, const Delta (&deltas)[N]) {
+    Bitboard b = 0;
+    for (const Delta& d : deltas)
+        if (onBoard((sq >> 3) + d.dr, (sq & 7) + d.df))
+            b |= squareBB(sq + d.dr * 8 + d.df);
+    return b;
+}
+
+template<std::size_t N>
+constexpr Bitboard slideAttacks(int sq, Bitboard occ, const Delta (&dirs)[N]) {
     Bitboard attacks = 0;
-    int r = rankOf(sq), f = fileOf(sq);
-    constexpr int dr[4] = {1, -1, 0, 0}, df[4] = {0, 0, 1, -1};
-    for (int d = 0; d < 4; ++d) {
-        for (int i = 1; i < 8; ++i) {
-            int nr = r + dr[d] * i, nf = f + df[d] * i;
-            if (nr < 0 || nr > 7 || nf < 0 || nf > 7) break;
-            int nsq = nr * 8 + nf;
-            attacks |= squareBB(nsq);
-            if (occ & squareBB(nsq)) break;
+    for (const Delta& d : dirs) {
+        for (int r = (sq >> 3) + d.dr, f = (sq & 7) + d.df; onBoard(r, f); r += d.dr, f += d.df) {
+            attacks |= squareBB(r * 8 + f);
+            if (occ & squareBB(r * 8 + f)) break;
         }
     }
     return attacks;
 }
 
-Bitboard slowBishopAttacks(int sq, Bitboard occ) {
-    Bitboard attacks = 0;
-    int r = rankOf(sq), f = fileOf(sq);
-    constexpr int dr[4] = {1, 1, -1, -1}, df[4] = {1, -1, 1, -1};
-    for (int d = 0; d < 4; ++d) {
-        for (int i = 1; i < 8; ++i) {
-            int nr = r + dr[d] * i, nf = f + df[d] * i;
-            if (nr < 0 || nr > 7 || nf < 0 || nf > 7) break;
-            int nsq = nr * 8 + nf;
-            attacks |= squareBB(nsq);
-            if (occ & squareBB(nsq)) break;
+template<typename F>
+constexpr std::array<Bitboard, 64> perSquare(F f) {
+    std::array<Bitboard, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) table[sq] = f(sq);
+    return table;
+}
+
+alignas(64) constexpr std::array<Bitboard, 64> KING_ATTACKS =
+    perSquare([](int sq) { return stepAttacks(sq, KING_DELTAS); });
+alignas(64) constexpr std::array<Bitboard, 64> KNIGHT_ATTACKS =
+    perSquare([](int sq) { return stepAttacks(sq, KNIGHT_DELTAS); });
+alignas(64) constexpr std::array<std::array<Bitboard, 64>, 2> PAWN_ATTACKS = {
+    perSquare([](int sq) { return (sq < 56 ? (shift<NORTH_WEST>(squareBB(sq)) | shift<NORTH_EAST>(squareBB(sq))) : 0); }),
+    perSquare([](int sq) { return (sq >= 8 ? (shift<SOUTH_WEST>(squareBB(sq)) | shift<SOUTH_EAST>(squareBB(sq))) : 0); })
+};
+
+// Between and line bitboards
+struct LineTables {
+    Bitboard between[64][64];
+    Bitboard line[64][64];
+};
+
+constexpr LineTables makeLineTables() {
+    LineTables t{};
+    for (int s1 = 0; s1 < 64; ++s1) {
+        for (int s2 = 0; s2 < 64; ++s2) {
+            if (s1 == s2) continue;
+
+            int r1 = s1 >> 3, f1 = s1 & 7;
+            int r2 = s2 >> 3, f2 = s2 & 7;
+            int dr = (r2 > r1) - (r2 < r1);
+            int df = (f2 > f1) - (f2 < f1);
+
+            bool onLine = (r1 == r2) || (f1 == f2) || (r2 - r1 == f2 - f1) || (r2 - r1 == f1 - f2);
+            if (!onLine) continue;
+
+            for (int r = r1 + dr, f = f1 + df; r != r2 || f != f2; r += dr, f += df)
+                t.between[s1][s2] |= squareBB(r * 8 + f);
+
+            for (int r = r1, f = f1; onBoard(r, f); r -= dr, f -= df)
+                t.line[s1][s2] |= squareBB(r * 8 + f);
+            for (int r = r1 + dr, f = f1 + df; onBoard(r, f); r += dr, f += df)
+                t.line[s1][s2] |= squareBB(r * 8 + f);
         }
     }
-    return attacks;
+    return t;
 }
 
-Bitboard rookMask(int sq) {
+alignas(64) constexpr LineTables LINES = makeLineTables();
+constexpr const auto& BETWEEN_BB = LINES.between;
+constexpr const auto& LINE_BB = LINES.line;
+
+// Magic bitboards: relevant occupancy excludes the board edge
+constexpr Bitboard rookMask(int sq) {
     Bitboard mask = 0;
-    int r = rankOf(sq), f = fileOf(sq);
+    int r = sq >> 3, f = sq & 7;
     for (int i = r + 1; i < 7; ++i) mask |= squareBB(i * 8 + f);
     for (int i = r - 1; i > 0; --i) mask |= squareBB(i * 8 + f);
     for (int i = f + 1; i < 7; ++i) mask |= squareBB(r * 8 + i);
@@ -220,9 +278,9 @@ Bitboard rookMask(int sq) {
     return mask;
 }
 
-Bitboard bishopMask(int sq) {
+constexpr Bitboard bishopMask(int sq) {
     Bitboard mask = 0;
-    int r = rankOf(sq), f = fileOf(sq);
+    int r = sq >> 3, f = sq & 7;
     for (int i = 1; r + i < 7 && f + i < 7; ++i) mask |= squareBB((r + i) * 8 + f + i);
     for (int i = 1; r + i < 7 && f - i > 0; ++i) mask |= squareBB((r + i) * 8 + f - i);
     for (int i = 1; r - i > 0 && f + i < 7; ++i) mask |= squareBB((r - i) * 8 + f + i);
@@ -230,160 +288,281 @@ Bitboard bishopMask(int sq) {
     return mask;
 }
 
-Bitboard indexToOccupancy(int index, Bitboard mask) {
-    Bitboard occ = 0;
-    while (mask) {
-        int sq = popLSB(mask);
-        if (index & 1) occ |= squareBB(sq);
-        index >>= 1;
-    }
-    return occ;
+struct MagicEntry {
+    Bitboard mask;
+    Bitboard magic;
+    const Bitboard* attacks;
+    int shift;
+};
+
+template<bool Rook, int Sq>
+constexpr Bitboard SLIDER_MASK = Rook ? rookMask(Sq) : bishopMask(Sq);
+template<bool Rook, int Sq>
+constexpr Bitboard SLIDER_MAGIC = Rook ? ROOK_MAGIC_NUMBERS[Sq] : BISHOP_MAGIC_NUMBERS[Sq];
+template<bool Rook, int Sq>
+constexpr int SLIDER_BITS = constPopCount(SLIDER_MASK<Rook, Sq>);
+
+// Portable pext for building tables; lookups use the BMI2 instruction
+constexpr Bitboard softPext(Bitboard src, Bitboard mask) {
+    Bitboard result = 0;
+    for (Bitboard bit = 1; mask; mask &= mask - 1, bit <<= 1)
+        if (src & mask & (~mask + 1)) result |= bit;
+    return result;
 }
 
-void init() {
-    std::call_once(initFlag, []() {
-        // King and knight attacks
-        for (int sq = 0; sq < 64; ++sq) {
-            int r = rankOf(sq), f = fileOf(sq);
-            
-            Bitboard k = 0;
-            for (int dr = -1; dr <= 1; ++dr)
-                for (int df = -1; df <= 1; ++df)
-                    if ((dr || df) && r + dr >= 0 && r + dr < 8 && f + df >= 0 && f + df < 8)
-                        k |= squareBB((r + dr) * 8 + f + df);
-            KING_ATTACKS[sq] = k;
-            
-            Bitboard n = 0;
-            constexpr int kd[8][2] = {{-2,-1},{-2,1},{-1,-2},{-1,2},{1,-2},{1,2},{2,-1},{2,1}};
-            for (auto [dr, df] : kd)
-                if (r + dr >= 0 && r + dr < 8 && f + df >= 0 && f + df < 8)
-                    n |= squareBB((r + dr) * 8 + f + df);
-            KNIGHT_ATTACKS[sq] = n;
-            
-            // Pawn attacks
-            Bitboard wpawn = 0, bpawn = 0;
-            if (r < 7) {
-                if (f > 0) wpawn |= squareBB(sq + 7);
-                if (f < 7) wpawn |= squareBB(sq + 9);
-            }
-            if (r > 0) {
-                if (f > 0) bpawn |= squareBB(sq - 9);
-                if (f < 7) bpawn |= squareBB(sq - 7);
-            }
-            PAWN_ATTACKS[WHITE][sq] = wpawn;
-            PAWN_ATTACKS[BLACK][sq] = bpawn;
-        }
-        
-        // Between and line bitboards
-        for (int s1 = 0; s1 < 64; ++s1) {
-            for (int s2 = 0; s2 < 64; ++s2) {
-                BETWEEN_BB[s1][s2] = 0;
-                LINE_BB[s1][s2] = 0;
-                if (s1 == s2) continue;
-                
-                int r1 = rankOf(s1), f1 = fileOf(s1);
-                int r2 = rankOf(s2), f2 = fileOf(s2);
-                int dr = (r2 > r1) - (r2 < r1);
-                int df = (f2 > f1) - (f2 < f1);
-                
-                bool onLine = (r1 == r2) || (f1 == f2) || (std::abs(r2-r1) == std::abs(f2-f1));
-                if (onLine) {
-                    for (int r = r1 + dr, f = f1 + df; r != r2 || f != f2; r += dr, f += df)
-                        BETWEEN_BB[s1][s2] |= squareBB(r * 8 + f);
-                    
-                    for (int r = r1, f = f1; r >= 0 && r < 8 && f >= 0 && f < 8; r -= dr, f -= df)
-                        LINE_BB[s1][s2] |= squareBB(r * 8 + f);
-                    for (int r = r1 + dr, f = f1 + df; r >= 0 && r < 8 && f >= 0 && f < 8; r += dr, f += df)
-                        LINE_BB[s1][s2] |= squareBB(r * 8 + f);
-                }
-            }
-        }
-        
-        // Magic bitboards
-        Bitboard* rookPtr = ROOK_TABLE;
-        for (int sq = 0; sq < 64; ++sq) {
-            auto& m = ROOK_MAGICS[sq];
-            m.mask = rookMask(sq);
-            m.magic = ROOK_MAGIC_NUMBERS[sq];
-            m.shift = 64 - popCount(m.mask);
-            m.attacks = rookPtr;
-            
-            int size = 1 << popCount(m.mask);
-            for (int i = 0; i < size; ++i) {
-                Bitboard occ = indexToOccupancy(i, m.mask);
-                int idx = static_cast<int>((occ * m.magic) >> m.shift);
-                m.attacks[idx] = slowRookAttacks(sq, occ);
-            }
-            rookPtr += size;
-        }
-        
-        Bitboard* bishopPtr = BISHOP_TABLE;
-        for (int sq = 0; sq < 64; ++sq) {
-            auto& m = BISHOP_MAGICS[sq];
-            m.mask = bishopMask(sq);
-            m.magic = BISHOP_MAGIC_NUMBERS[sq];
-            m.shift = 64 - popCount(m.mask);
-            m.attacks = bishopPtr;
-            
-            int size = 1 << popCount(m.mask);
-            for (int i = 0; i < size; ++i) {
-                Bitboard occ = indexToOccupancy(i, m.mask);
-                int idx = static_cast<int>((occ * m.magic) >> m.shift);
-                m.attacks[idx] = slowBishopAttacks(sq, occ);
-            }
-            bishopPtr += size;
+// Plain array wrapper: element stores into it are much cheaper for the
+// compiler's constant evaluator than std::array::operator[]
+template<std::size_t N>
+struct AttackTable { Bitboard v[N]; };
+
+// One table per square, so each is a separate (small) constant evaluation
+// that stays within the default constexpr step limits of every compiler.
+// A slider attacks along two independent lines (file and rank, or the two
+// diagonals; consecutive pairs in *_DIRS), so each line's attacks are worked
+// out once per line occupancy and the table entries just combine them.
+// Pext tables index by pext(occ, mask) instead of the magic product; the
+// two lines are disjoint bits of the mask, so their pext indices just OR.
+template<bool Rook, int Sq, bool Pext>
+constexpr auto buildSliderAttacks() {
+    constexpr const Delta (&dirs)[4] = Rook ? ROOK_DIRS : BISHOP_DIRS;
+    constexpr Delta lineA[2] = {dirs[0], dirs[1]}, lineB[2] = {dirs[2], dirs[3]};
+    constexpr Bitboard maskA = SLIDER_MASK<Rook, Sq> & slideAttacks(Sq, 0, lineA);
+    constexpr Bitboard maskB = SLIDER_MASK<Rook, Sq> & ~maskA;
+    constexpr int shift = 64 - SLIDER_BITS<Rook, Sq>;
+
+    Bitboard occA[64]{}, attA[64]{}, occB[64]{}, attB[64]{};
+    int nA = 0, nB = 0;
+    Bitboard occ = 0;
+    do {  // Carry-Rippler: every subset of the line mask
+        occA[nA] = occ;
+        attA[nA++] = slideAttacks(Sq, occ, lineA);
+        occ = (occ - maskA) & maskA;
+    } while (occ);
+    do {
+        occB[nB] = occ;
+        attB[nB++] = slideAttacks(Sq, occ, lineB);
+        occ = (occ - maskB) & maskB;
+    } while (occ);
+
+    AttackTable<std::size_t(1) << SLIDER_BITS<Rook, Sq>> table{};
+    for (int a = 0; a < nA; ++a)
+        for (int b = 0; b < nB; ++b) {
+            std::size_t idx = Pext ? (softPext(occA[a], SLIDER_MASK<Rook, Sq>) | softPext(occB[b], SLIDER_MASK<Rook, Sq>))
+                                   : ((occA[a] | occB[b]) * SLIDER_MAGIC<Rook, Sq>) >> shift;
+            table.v[idx] = attA[a] | attB[b];
         }
-    });
+    return table;
 }
 
+template<bool Rook, int Sq, bool Pext = false>
+alignas(64) constexpr auto SLIDER_ATTACKS = buildSliderAttacks<Rook, Sq, Pext>();
+
+template<bool Rook, std::size_t... Sq>
+constexpr std::array<MagicEntry, 64> makeMagics(std::index_sequence<Sq...>) {
+    return {{ MagicEntry{SLIDER_MASK<Rook, Sq>, SLIDER_MAGIC<Rook, Sq>,
+                         SLIDER_ATTACKS<Rook, Sq>.v, 64 - SLIDER_BITS<Rook, Sq>}... }};
+}
+
+alignas(64) constexpr std::array<MagicEntry, 64> ROOK_MAGICS = makeMagics<true>(std::make_index_sequence<64>{});
+alignas(64) constexpr std::array<MagicEntry, 64> BISHOP_MAGICS = makeMagics<false>(std::make_index_sequence<64>{});
+
+// PEXT entries reuse MagicEntry (magic and shift unused); only built when referenced
+template<bool Rook, std::size_t... Sq>
+constexpr std::array<MagicEntry, 64> makePextEntries(std::index_sequence<Sq...>) {
+    return {{ MagicEntry{SLIDER_MASK<Rook, Sq>, 0, SLIDER_ATTACKS<Rook, Sq, true>.v, 0}... }};
+}
+
+template<bool Rook>
+alignas(64) constexpr std::array<MagicEntry, 64> PEXT_ENTRIES = makePextEntries<Rook>(std::make_index_sequence<64>{});
+
+// Kindergarten bitboards: every line is mapped onto a 6-bit inner occupancy
+// by one multiply, and ~8 KB of tables give the attacks on that line
+constexpr Bitboard FILE_B_BB = FILE_A << 1;
+constexpr Bitboard DIAG_C7_H2 = 0x0004081020408000ULL;
+
+struct KindergartenTables {
+    Bitboard fillUp[8][64];      // Rank attacks of a slider on file f, copied to every rank
+    Bitboard aFile[8][64];       // File A attacks of a slider on rank r
+    Bitboard rankMask[64], fileMask[64], diagMask[64], antiMask[64];  // Lines through sq, sq excluded
+};
+
+constexpr KindergartenTables makeKindergarten() {
+    KindergartenTables t{};
+    constexpr Delta rank[2] = {{0,1},{0,-1}}, file[2] = {{1,0},{-1,0}};
+    constexpr Delta diag[2] = {{1,1},{-1,-1}}, anti[2] = {{1,-1},{-1,1}};
+    for (int i = 0; i < 8; ++i) {
+        // Same index functions as the lookups, applied to every inner occupancy
+        Bitboard innerRank = RANK_1 & ~squareBB(0) & ~squareBB(7);
+        Bitboard innerFile = FILE_A & ~RANK_1 & ~RANK_8;
+        Bitboard occ = 0;
+        do {
+            t.fillUp[i][(occ * FILE_B_BB) >> 58] = slideAttacks(i, occ, rank) * FILE_A;
+            occ = (occ - innerRank) & innerRank;
+        } while (occ);
+        do {
+            t.aFile[i][(occ * DIAG_C7_H2) >> 58] = slideAttacks(i * 8, occ, file);
+            occ = (occ - innerFile) & innerFile;
+        } while (occ);
+    }
+    for (int sq = 0; sq < 64; ++sq) {
+        t.rankMask[sq] = slideAttacks(sq, 0, rank);
+        t.fileMask[sq] = slideAttacks(sq, 0, file);
+        t.diagMask[sq] = slideAttacks(sq, 0, diag);
+        t.antiMask[sq] = slideAttacks(sq, 0, anti);
+    }
+    return t;
+}
+
+alignas(64) constexpr KindergartenTables KINDERGARTEN = makeKindergarten();
+
 } // namespace Tables
 
 //============================================================================
 // Zobrist hashing - shared for repetition detection
 //============================================================================
 namespace Zobrist {
-    inline std::array<std::array<std::array<std::uint64_t, 64>, 6>, 2> PIECE{};
-    inline std::array<std::uint64_t, 16> CASTLING{};
-    inline std::array<std::uint64_t, 8> EP{};
-    inline std::uint64_t SIDE = 0;
-    inline std::once_flag initFlag;
-
-    inline std::uint64_t splitmix64(std::uint64_t& x) {
+    constexpr std::uint64_t splitmix64(std::uint64_t& x) {
         std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
         z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
         z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
         return z ^ (z >> 31);
     }
 
-    inline void init() {
-        std::call_once(initFlag, []() {
-            std::uint64_t seed = 0x123456789abcdefULL;
-            for (int c = 0; c < 2; ++c) {
-                for (int pt = 0; pt < 6; ++pt) {
-                    for (int sq = 0; sq < 64; ++sq) {
-                        PIECE[c][pt][sq] = splitmix64(seed);
-                    }
-                }
-            }
-            for (int i = 0; i < 16; ++i) CASTLING[i] = splitmix64(seed);
-            for (int i = 0; i < 8; ++i) EP[i] = splitmix64(seed);
-            SIDE = splitmix64(seed);
-        });
+    struct Keys {
+        // [colour][type][sq]; types 6 and 7 stay zero so a mailbox byte
+        // (colour << 3 | type, 0xFF when empty) indexes it without a branch
+        std::array<std::array<std::array<std::uint64_t, 64>, 8>, 2> piece{};
+        std::array<std::uint64_t, 16> castling{};
+        std::array<std::uint64_t, 8> ep{};
+        std::uint64_t side = 0;
+    };
+
+    constexpr Keys makeKeys() {
+        Keys k{};
+        std::uint64_t seed = 0x123456789abcdefULL;
+        for (int c = 0; c < 2; ++c)
+            for (int pt = 0; pt < 6; ++pt)
+                for (int sq = 0; sq < 64; ++sq)
+                    k.piece[c][pt][sq] = splitmix64(seed);
+        for (int i = 0; i < 16; ++i) k.castling[i] = splitmix64(seed);
+        for (int i = 0; i < 8; ++i) k.ep[i] = splitmix64(seed);
+        k.side = splitmix64(seed);
+        return k;
     }
+
+    alignas(64) inline constexpr Keys KEYS = makeKeys();
+    inline constexpr const auto& PIECE = KEYS.piece;
+    inline constexpr const auto& CASTLING = KEYS.castling;
+    inline constexpr const auto& EP = KEYS.ep;
+    inline constexpr std::uint64_t SIDE = KEYS.side;
 } // namespace Zobrist
 
 //============================================================================
 // OPTIMIZATION 9: Inline attack lookups
+// Slider backends, selected at compile time:
+//   (default)          fancy magics, ~840 KB of tables
+//   -DUSE_PEXT         BMI2 pext indexing, same tables without the multiply
+//   -DUSE_KINDERGARTEN kindergarten bitboards, ~8 KB of tables
+//   -DUSE_KOGGE_STONE  Kogge-Stone occluded fills, no tables at all
+// All of them are compiled for the "sliderbench" comparison. In a dispatch
+// build (see thisbot.cpp) the BMI2 copy of the engine uses pext by default.
 //============================================================================
-FORCE_INLINE Bitboard rookAttacks(int sq, Bitboard occ) {
-    const auto& e = Tables::ROOK_MAGICS[sq];
-    return e.attacks[((occ & e.mask) * e.magic) >> e.shift];
-}
+namespace Sliders {
 
-FORCE_INLINE Bitboard bishopAttacks(int sq, Bitboard occ) {
-    const auto& e = Tables::BISHOP_MAGICS[sq];
-    return e.attacks[((occ & e.mask) * e.magic) >> e.shift];
-}
+struct Magic {
+    static constexpr const char* NAME = "magic";
+    static FORCE_INLINE Bitboard rook(int sq, Bitboard occ) {
+        const auto& e = Tables::ROOK_MAGICS[sq];
+        return e.attacks[((occ & e.mask) * e.magic) >> e.shift];
+    }
+    static FORCE_INLINE Bitboard bishop(int sq, Bitboard occ) {
+        const auto& e = Tables::BISHOP_MAGICS[sq];
+        return e.attacks[((occ & e.mask) * e.magic) >> e.shift];
+    }
+};
+
+#if defined(__BMI2__) || defined(ENGINE_TARGET_BMI2)
+struct Pext {
+    static constexpr const char* NAME = "pext";
+    static FORCE_INLINE Bitboard rook(int sq, Bitboard occ) {
+        const auto& e = Tables::PEXT_ENTRIES<true>[sq];
+        return e.attacks[_pext_u64(occ, e.mask)];
+    }
+    static FORCE_INLINE Bitboard bishop(int sq, Bitboard occ) {
+        const auto& e = Tables::PEXT_ENTRIES<false>[sq];
+        return e.attacks[_pext_u64(occ, e.mask)];
+    }
+};
+#endif
+
+struct Kindergarten {
+    static constexpr const char* NAME = "kindergarten";
+    static FORCE_INLINE Bitboard line(Bitboard mask, int sq, Bitboard occ) {
+        return mask & Tables::KINDERGARTEN.fillUp[sq & 7][((mask & occ) * Tables::FILE_B_BB) >> 58];
+    }
+    static FORCE_INLINE Bitboard file(int sq, Bitboard occ) {
+        occ = FILE_A & (occ >> (sq & 7));
+        return Tables::KINDERGARTEN.aFile[sq >> 3][(occ * Tables::DIAG_C7_H2) >> 58] << (sq & 7);
+    }
+    static FORCE_INLINE Bitboard rook(int sq, Bitboard occ) {
+        return line(Tables::KINDERGARTEN.rankMask[sq], sq, occ) | file(sq, occ);
+    }
+    static FORCE_INLINE Bitboard bishop(int sq, Bitboard occ) {
+        return line(Tables::KINDERGARTEN.diagMask[sq], sq, occ) | line(Tables::KINDERGARTEN.antiMask[sq], sq, occ);
+    }
+};
+
+struct KoggeStone {
+    static constexpr const char* NAME = "kogge-stone";
+
+    // Attacks of every slider in gen in direction D, stopping at (and including)
+    // blockers. T is a Bitboard or a batch of them (see LaneBB in batch.cpp).
+    template<int D, typename T>
+    static FORCE_INLINE T ray(T gen, T empty) {
+        constexpr Bitboard wrap = (D == 1 || D == NORTH_EAST || D == SOUTH_EAST) ? NOT_FILE_A
+                                : (D == -1 || D == NORTH_WEST || D == SOUTH_WEST) ? NOT_FILE_H : ~0ULL;
+        empty &= wrap;
+        gen |= empty & shift<D>(gen);
+        empty &= shift<D>(empty);
+        gen |= empty & shift<2 * D>(gen);
+        empty &= shift<2 * D>(empty);
+        gen |= empty & shift<4 * D>(gen);
+        return shift<D>(gen) & wrap;
+    }
+    // A member rather than a local lambda: GCC compiled the lambda without
+    // the per-ISA target options, so a vector T crossed it on the baseline ABI
+    template<int N, typename T>
+    static FORCE_INLINE T shift(const T& b) {
+        if constexpr (N > 0) return b << N;
+        else return b >> -N;
+    }
+    static FORCE_INLINE Bitboard rook(int sq, Bitboard occ) {
+        Bitboard b = squareBB(sq), e = ~occ;
+        return ray<NORTH>(b, e) | ray<SOUTH>(b, e) | ray<1>(b, e) | ray<-1>(b, e);
+    }
+    static FORCE_INLINE Bitboard bishop(int sq, Bitboard occ) {
+        Bitboard b = squareBB(sq), e = ~occ;
+        return ray<NORTH_EAST>(b, e) | ray<NORTH_WEST>(b, e) | ray<SOUTH_EAST>(b, e) | ray<SOUTH_WEST>(b, e);
+    }
+};
+
+#if defined(USE_KINDERGARTEN)
+    using Active = Kindergarten;
+#elif defined(USE_KOGGE_STONE)
+    using Active = KoggeStone;
+#elif defined(ENGINE_TARGET_BMI2) || (defined(USE_PEXT) && defined(__BMI2__))
+    using Active = Pext;
+#elif defined(USE_PEXT) && !defined(ENGINE_DISPATCH)
+    #error "USE_PEXT needs a BMI2 target (e.g. -mbmi2 or -march=native on a BMI2 CPU)"
+#else
+    using Active = Magic;
+#endif
+
+} // namespace Sliders
+
+FORCE_INLINE Bitboard rookAttacks(int sq, Bitboard occ) { return Sliders::Active::rook(sq, occ); }
+
+FORCE_INLINE Bitboard bishopAttacks(int sq, Bitboard occ) { return Sliders::Active::bishop(sq, occ); }
 
 FORCE_INLINE Bitboard queenAttacks(int sq, Bitboard occ) {
     return rookAttacks(sq, occ) | bishopAttacks(sq, occ);
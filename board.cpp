@@ -1,50 +1,158 @@
 namespace chess {
-class Board {
+
+//============================================================================
+// FEN errors
+//============================================================================
+enum class FenError : std::uint8_t {
+    None, Placement, KingCount, PawnOnBackRank, SideToMove, Castling,
+    EnPassant, Clock, TrailingData, OpponentInCheck
+};
+
+inline const char* fenErrorString(FenError e) {
+    switch (e) {
+        case FenError::None: return "ok";
+        case FenError::Placement: return "piece placement needs 8 ranks of 8 squares, letters PNBRQK";
+        case FenError::KingCount: return "each side needs exactly one king";
+        case FenError::PawnOnBackRank: return "pawn on the first or last rank";
+        case FenError::SideToMove: return "side to move must be w or b";
+        case FenError::Castling: return "castling rights malformed or without king and rook at home";
+        case FenError::EnPassant: return "en passant square impossible for this position";
+        case FenError::Clock: return "move counters malformed or out of range";
+        case FenError::TrailingData: return "unexpected text after the move counters";
+        case FenError::OpponentInCheck: return "side not to move is in check";
+    }
+    return "unknown error";
+}
+
+// Per FEN placement character: mailbox byte and squares covered. Anything
+// that is not a piece, a digit 1-8 or '/' covers 9 squares, which no rank
+// can take, so it fails the length check
+struct FenCharTables {
+    std::uint8_t code[256];
+    std::uint8_t advance[256];
+};
+
+constexpr FenCharTables makeFenCharTables() {
+    FenCharTables t{};
+    const char* letters = "PNBRQKpnbrqk";
+    for (int i = 0; i < 256; ++i) { t.code[i] = 0xFF; t.advance[i] = 9; }
+    for (int i = 0; i < 12; ++i) {
+        t.code[std::uint8_t(letters[i])] = std::uint8_t((i % 6) | (i / 6) << 3);
+        t.advance[std::uint8_t(letters[i])] = 1;
+    }
+    for (int n = 1; n <= 8; ++n) t.advance['0' + n] = std::uint8_t(n);
+    t.advance[std::uint8_t('/')] = 0;
+    return t;
+}
+
+inline constexpr FenCharTables FEN_CHARS = makeFenCharTables();
+inline constexpr const auto& FEN_CHAR_CODE = FEN_CHARS.code;
+inline constexpr const auto& FEN_CHAR_ADVANCE = FEN_CHARS.advance;
+
+// Longest FEN: 71 placement + 1 side + 4 castling + 2 ep + 3 + 5 counters + 5 spaces, plus NUL
+constexpr int FEN_BUFFER_SIZE = 96;
+
+//============================================================================
+// OPTIMIZATION 14: Cache-line layout
+// makeMove touches the bitboards, the hash, the small state and the check
+// info on every call, so they fill exactly four aligned lines in that order.
+// The mailbox gets the fifth line to itself and the cold fields (full-move
+// base) the sixth: a Board is 384 bytes. The state stack belongs to the
+// caller (see StateStack), so nothing the hot path writes shares a line with
+// the repetition history and a copy is six lines.
+//============================================================================
+class alignas(64) Board {
 public:
-    // Bitboards
+    // OPTIMIZATION: Check information for the side to move, computed once per
+    // position in makeMove so generation, legality and givesCheck() share it
+    struct CheckInfo {
+        Bitboard checkers;        // Enemy pieces attacking our king
+        Bitboard pinned;          // Our pieces pinned to our king
+        Bitboard discoverers;     // Our pieces whose move may uncover a check
+        Bitboard checkSquares[6]; // Squares from which each piece type would check
+    };
+
+    // Lines 0-1: bitboards and hash
     Bitboard pieces_[2][6]{};
     Bitboard byColor_[2]{};
     Bitboard occupied_{};
-    
-    // OPTIMIZATION: Mailbox for O(1) piece/color lookup
-    std::uint8_t mailbox_[64];  // piece type in low 3 bits, color in bit 3, empty = 0xFF
-    
+    std::uint64_t hash_ = 0;  // Current position hash
+
+    // Lines 2-3: small state, then the check info
     Color sideToMove_ = WHITE;
     CastlingRights castling_ = ALL_CASTLING;
     std::int8_t epSquare_ = -1;
     std::uint8_t halfmove_ = 0;
-    std::uint16_t fullmove_ = 1;
-    
-    // Cached king squares for fast check detection
-    std::uint8_t kingSquare_[2];
+    std::uint8_t kingSquare_[2];  // Cached king squares for fast check detection
+    int stateCount_ = 0;          // Plies pushed since setFEN/clear
+    struct StateInfo;
+    StateInfo* states_ = nullptr; // The caller's StateStack
+    CheckInfo checkInfo_{};
 
-    // Position history for repetition detection
-    std::vector<std::uint64_t> history_;
-    std::uint64_t hash_ = 0;  // Current position hash
+    // Line 4: OPTIMIZATION: Mailbox for O(1) piece/color lookup
+    alignas(64) std::uint8_t mailbox_[64];  // piece type in low 3 bits, color in bit 3, empty = 0xFF
 
-    void rebuildMailboxAndHash() {
-        std::memset(mailbox_, 0xFF, sizeof(mailbox_));
-        byColor_[0] = byColor_[1] = occupied_ = 0;
-        kingSquare_[0] = kingSquare_[1] = 255;
+    // Cold: the full-move number is derived from these and stateCount_
+    std::uint16_t startFullmove_ = 1;
+    Color startSide_ = WHITE;
 
-        for (int c = 0; c < 2; ++c) {
-            for (int pt = 0; pt < 6; ++pt) {
-                Bitboard pcs = pieces_[c][pt];
-                while (pcs) {
-                    int sq = popLSB(pcs);
-                    putPiece(static_cast<Color>(c), static_cast<PieceType>(pt), sq);
-                }
-            }
-        }
-        hash_ = computeHash();
+    //========================================================================
+    // OPTIMIZATION 11: Fixed-capacity state stack
+    //========================================================================
+    // One entry per makeMove/makeNullMove holding what unmake cannot recompute
+    // cheaply; doubles as the repetition history. The stack is a ring so games
+    // of any length fit: only the last STATE_CAPACITY plies can be unmade or
+    // compared for repetition, far beyond the search's ply limit and the
+    // 50-move window.
+    //
+    // The stack is not part of the Board: whoever plays the moves (a game, a
+    // search or perft worker, a benchmark) owns a StateStack and lends it,
+    // usually on its own thread's stack, so Board stays a plain value. A copy
+    // shares its original's stack; a copy that plays on by itself, such as a
+    // worker thread's, moves to a stack of its own with useStates().
+    struct StateInfo {
+        std::uint64_t key;
+        CheckInfo checkInfo;
+        CastlingRights castling;
+        std::int8_t ep;
+        std::uint8_t halfmove;
+        PieceType captured;
+    };
+
+    static constexpr int STATE_CAPACITY = 256;  // power of two
+
+    struct StateStack {
+        StateInfo entries[STATE_CAPACITY];
+    };
+
+    // Play on in `stack`, taking along the history pushed so far
+    void useStates(StateStack& stack) {
+        if (states_ && states_ != stack.entries)
+            std::memcpy(stack.entries, states_, std::min(stateCount_, STATE_CAPACITY) * sizeof(StateInfo));
+        states_ = stack.entries;
     }
 
-    Board() {
-        Tables::init();
-        Zobrist::init();  // Initialize Zobrist keys
-        clear();
+    FORCE_INLINE StateInfo& pushState(PieceType captured) {
+        assert(states_ && "moves need a StateStack");
+        StateInfo& st = states_[stateCount_++ & (STATE_CAPACITY - 1)];
+        st.key = hash_;
+        st.checkInfo = checkInfo_;
+        st.castling = castling_;
+        st.ep = epSquare_;
+        st.halfmove = halfmove_;
+        st.captured = captured;
+        return st;
     }
 
+    FORCE_INLINE const StateInfo& popState() {
+        return states_[--stateCount_ & (STATE_CAPACITY - 1)];
+    }
+
+    // Without a stack a Board can be set up, read and written as FEN, but
+    // not moved on
+    Board() { clear(); }
+    explicit Board(StateStack& stack) : states_(stack.entries) { clear(); }
+
     void clear() {
         std::memset(pieces_, 0, sizeof(pieces_));
         std::memset(mailbox_, 0xFF, sizeof(mailbox_));
@@ -53,21 +161,20 @@ public:
         castling_ = NO_CASTLING;
         epSquare_ = -1;
         halfmove_ = 0;
-        fullmove_ = 1;
+        startFullmove_ = 1;
+        startSide_ = WHITE;
         kingSquare_[0] = kingSquare_[1] = 255;
-        history_.clear();
+        stateCount_ = 0;
         hash_ = 0;
+        checkInfo_ = {};
     }
 
     // Compute hash from scratch
     std::uint64_t computeHash() const {
         std::uint64_t h = 0;
         for (int sq = 0; sq < 64; ++sq) {
-            if (mailbox_[sq] != 0xFF) {
-                int pt = mailbox_[sq] & 7;
-                int c = (mailbox_[sq] >> 3) & 1;
-                h ^= Zobrist::PIECE[c][pt][sq];
-            }
+            int m = mailbox_[sq];  // Empty squares hit the zero row PIECE[1][7]
+            h ^= Zobrist::PIECE[(m >> 3) & 1][m & 7][sq];
         }
         h ^= Zobrist::CASTLING[castling_];
         if (epSquare_ >= 0) h ^= Zobrist::EP[epSquare_ & 7];
@@ -75,18 +182,21 @@ public:
         return h;
     }
 
+    // Null moves count as plies too, but none are on the stack outside search
+    int fullmove() const { return std::min(startFullmove_ + (stateCount_ + startSide_) / 2, 0xFFFF); }
+
     // Check for repetition (returns true if position occurred before)
     // For 3-fold, we need the position to appear 2 more times (already appeared once = current)
     bool isRepetition(int searchPly = 0) const {
-        if (history_.size() < 4) return false;  // Need at least 4 plies for repetition
+        if (stateCount_ < 4) return false;  // Need at least 4 plies for repetition
         
         int count = 0;
         // Only check positions since last irreversible move (limited by halfmove clock)
         // Also limit by searchPly to only count positions from before the search started
-        int limit = std::min(static_cast<int>(history_.size()), static_cast<int>(halfmove_));
+        int limit = std::min({stateCount_, static_cast<int>(halfmove_), STATE_CAPACITY});
         
         for (int i = 2; i <= limit; i += 2) {  // Step by 2 (same side to move)
-            if (history_[history_.size() - i] == hash_) {
+            if (states_[(stateCount_ - i) & (STATE_CAPACITY - 1)].key == hash_) {
                 count++;
                 if (count >= 2) return true;  // 3-fold (current + 2 previous)
                 // In search, we can return true on first repetition for efficiency
@@ -137,6 +247,11 @@ public:
         return mailbox_[sq] == 0xFF;
     }
     
+    // Piece a move takes, NO_PIECE for quiet moves (empty squares read as NO_PIECE)
+    FORCE_INLINE PieceType capturedPiece(Move m) const {
+        return m.type() == MT_EN_PASSANT ? PAWN : pieceAt(m.to());
+    }
+
     FORCE_INLINE int kingSq(Color c) const {
         return kingSquare_[c];
     }
@@ -178,65 +293,120 @@ public:
         return false;
     }
     
-    FORCE_INLINE Bitboard checkers() const {
-        return attackersTo(kingSq(sideToMove_), occupied_, ~sideToMove_);
-    }
+    FORCE_INLINE Bitboard checkers() const { return checkInfo_.checkers; }
     
-    FORCE_INLINE bool inCheck() const {
-        return isAttacked(kingSq(sideToMove_), ~sideToMove_);
-    }
+    FORCE_INLINE bool inCheck() const { return checkInfo_.checkers != 0; }
 
-    //========================================================================
-    // OPTIMIZATION 11: Undo info - compact
-    //========================================================================
-    struct UndoInfo {
-        std::uint32_t data;  // packed: castling, ep, halfmove, captured piece
-        
-        FORCE_INLINE CastlingRights castling() const { return CastlingRights(data & 0xF); }
-        FORCE_INLINE int ep() const { return ((data >> 4) & 0x7F) - 1; }
-        FORCE_INLINE int halfmove() const { return (data >> 11) & 0xFF; }
-        FORCE_INLINE PieceType captured() const { return PieceType((data >> 19) & 0x7); }
-        FORCE_INLINE bool isInvalid() const { return (data & 0x80000000u) != 0; }
-        
-        static UndoInfo make(CastlingRights c, int ep, int hm, PieceType cap) {
-            return {std::uint32_t(c) | (std::uint32_t(ep + 1) << 4) | 
-                   (std::uint32_t(hm) << 11) | (std::uint32_t(cap) << 19)};
+    // Pieces of colour `blockers` that are the only piece between sq and a
+    // slider of colour `sliders` (pins when sliders are the enemy's)
+    Bitboard sliderBlockers(int sq, Color blockers, Color sliders) const {
+        Bitboard result = 0;
+
+        // Mask out the blocking side to see "through" it for snipers
+        Bitboard occ = occupied_ ^ byColor_[blockers];
+        Bitboard snipers = ((rookAttacks(sq, occ) & (pieces_[sliders][ROOK] | pieces_[sliders][QUEEN]))
+                          | (bishopAttacks(sq, occ) & (pieces_[sliders][BISHOP] | pieces_[sliders][QUEEN])));
+
+        while (snipers) {
+            int sniper = popLSB(snipers);
+            Bitboard between = Tables::BETWEEN_BB[sq][sniper] & occupied_;
+            if (popCount(between) == 1) result |= between & byColor_[blockers];
         }
-        static UndoInfo makeInvalid() { return {0x80000000u}; }
-    };
+        return result;
+    }
 
-    struct NullUndo {
-        std::int8_t ep;
-        std::uint8_t halfmove;
-        CastlingRights castling;
-    };
+    void updateCheckInfo() {
+        if (sideToMove_ == WHITE) updateCheckInfo<WHITE>();
+        else updateCheckInfo<BLACK>();
+    }
+
+    template<Color Us>
+    void updateCheckInfo() {
+        constexpr Color Them = ~Us;
+        int ksq = kingSq(Us), theirK = kingSq(Them);
+        if (ksq > 63 || theirK > 63) { checkInfo_ = {}; return; }
+
+        CheckInfo& ci = checkInfo_;
+        ci.checkers = attackersTo(ksq, occupied_, Them);
+        ci.pinned = sliderBlockers(ksq, Us, Them);
+        ci.discoverers = sliderBlockers(theirK, Us, Us);
+        ci.checkSquares[PAWN] = Tables::PAWN_ATTACKS[Them][theirK];
+        ci.checkSquares[KNIGHT] = Tables::KNIGHT_ATTACKS[theirK];
+        ci.checkSquares[BISHOP] = bishopAttacks(theirK, occupied_);
+        ci.checkSquares[ROOK] = rookAttacks(theirK, occupied_);
+        ci.checkSquares[QUEEN] = ci.checkSquares[BISHOP] | ci.checkSquares[ROOK];
+        ci.checkSquares[KING] = 0;
+    }
+
+    // Whether a legal move checks the opponent, decided before makeMove
+    bool givesCheck(Move m) const {
+        const CheckInfo& ci = checkInfo_;
+        Color us = sideToMove_;
+        int from = m.from(), to = m.to();
+        int theirK = kingSq(~us);
+        MoveType mt = m.type();
+
+        // Direct check (the promoting pawn is handled below)
+        if (mt != MT_PROMOTION && (ci.checkSquares[pieceAt(from)] & squareBB(to))) return true;
+
+        // Discovered check: a blocker leaving the line to the enemy king
+        if ((ci.discoverers & squareBB(from)) &&
+            (!(Tables::LINE_BB[from][theirK] & squareBB(to)) || mt == MT_CASTLING)) return true;
+
+        switch (mt) {
+            case MT_PROMOTION: {
+                Bitboard occ = occupied_ ^ squareBB(from);
+                Bitboard attacks = m.promo() == KNIGHT ? Tables::KNIGHT_ATTACKS[to]
+                                 : m.promo() == BISHOP ? bishopAttacks(to, occ)
+                                 : m.promo() == ROOK ? rookAttacks(to, occ)
+                                 : queenAttacks(to, occ);
+                return attacks & squareBB(theirK);
+            }
+            case MT_EN_PASSANT: {
+                // The captured pawn may also have been a blocker
+                int capSq = to + (us == WHITE ? -8 : 8);
+                Bitboard occ = (occupied_ ^ squareBB(from) ^ squareBB(capSq)) | squareBB(to);
+                return (rookAttacks(theirK, occ) & (pieces_[us][ROOK] | pieces_[us][QUEEN]))
+                     | (bishopAttacks(theirK, occ) & (pieces_[us][BISHOP] | pieces_[us][QUEEN]));
+            }
+            case MT_CASTLING: {
+                int idx = us * 2 + ((fileOf(to) == 6) ? 0 : 1);
+                int rookFrom = Tables::CASTLING_ROOK_FROM[idx], rookTo = Tables::CASTLING_ROOK_TO[idx];
+                Bitboard occ = (occupied_ ^ squareBB(from) ^ squareBB(rookFrom)) | squareBB(to) | squareBB(rookTo);
+                return rookAttacks(rookTo, occ) & squareBB(theirK);
+            }
+            default:
+                return false;
+        }
+    }
 
     //========================================================================
     // Make/Unmake moves - optimized with incremental hash updates
     //========================================================================
-    // Update makeMove to track hash incrementally and update history
-    UndoInfo makeMove(Move m) {
-        // Save current hash to history BEFORE making the move
-        history_.push_back(hash_);
-        
-        Color us = sideToMove_;
-        Color them = ~us;
+    void makeMove(Move m) {
+        if (sideToMove_ == WHITE) makeMove<WHITE>(m);
+        else makeMove<BLACK>(m);
+    }
+
+    void unmakeMove(Move m) {
+        // sideToMove_ is still the opponent of the side that moved
+        if (sideToMove_ == BLACK) unmakeMove<WHITE>(m);
+        else unmakeMove<BLACK>(m);
+    }
+
+    template<Color Us>
+    void makeMove(Move m) {
+        constexpr Color Them = ~Us;
+        constexpr int Up = Us == WHITE ? NORTH : SOUTH;
         int from = m.from(), to = m.to();
         MoveType mt = m.type();
         PieceType moving = pieceAt(from);
-        if (moving == NO_PIECE) {
-            // Repair any mailbox/piece bitboard divergence and retry
-            rebuildMailboxAndHash();
-            if (!history_.empty()) history_.back() = hash_;
-            moving = pieceAt(from);
-        }
-        if (moving == NO_PIECE) {
-            // Bail out gracefully if the move is clearly invalid
-            return UndoInfo::makeInvalid();
-        }
+        // Mailbox and bitboards must agree; moves come from our own generators
+        assert(sideToMove_ == Us && moving != NO_PIECE && (pieces_[Us][moving] & squareBB(from)));
         PieceType captured = isEmpty(to) ? NO_PIECE : pieceAt(to);
         
-        UndoInfo undo = UndoInfo::make(castling_, epSquare_, halfmove_, captured);
+        // Save the irreversible state BEFORE making the move
+        pushState(captured);
         
         // Update hash: remove old castling rights and ep
         hash_ ^= Zobrist::CASTLING[castling_];
@@ -246,41 +416,40 @@ public:
         epSquare_ = -1;
         
         if (mt == MT_CASTLING) {
-            int side = (fileOf(to) == 6) ? 0 : 1;
-            int idx = us * 2 + side;
+            int idx = Us * 2 + (fileOf(to) == 6 ? 0 : 1);
             
             // Update hash for king move
-            hash_ ^= Zobrist::PIECE[us][KING][from];
-            hash_ ^= Zobrist::PIECE[us][KING][to];
+            hash_ ^= Zobrist::PIECE[Us][KING][from];
+            hash_ ^= Zobrist::PIECE[Us][KING][to];
             // Update hash for rook move
-            hash_ ^= Zobrist::PIECE[us][ROOK][Tables::CASTLING_ROOK_FROM[idx]];
-            hash_ ^= Zobrist::PIECE[us][ROOK][Tables::CASTLING_ROOK_TO[idx]];
+            hash_ ^= Zobrist::PIECE[Us][ROOK][Tables::CASTLING_ROOK_FROM[idx]];
+            hash_ ^= Zobrist::PIECE[Us][ROOK][Tables::CASTLING_ROOK_TO[idx]];
             
-            movePiece(us, KING, from, to);
-            movePiece(us, ROOK, Tables::CASTLING_ROOK_FROM[idx], Tables::CASTLING_ROOK_TO[idx]);
+            movePiece(Us, KING, from, to);
+            movePiece(Us, ROOK, Tables::CASTLING_ROOK_FROM[idx], Tables::CASTLING_ROOK_TO[idx]);
         } else {
             if (captured != NO_PIECE) {
-                hash_ ^= Zobrist::PIECE[them][captured][to];
-                removePiece(them, captured, to);
+                hash_ ^= Zobrist::PIECE[Them][captured][to];
+                removePiece(Them, captured, to);
             }
             
             if (mt == MT_EN_PASSANT) {
-                int capSq = to + (us == WHITE ? -8 : 8);
-                hash_ ^= Zobrist::PIECE[them][PAWN][capSq];
-                removePiece(them, PAWN, capSq);
+                int capSq = to - Up;
+                hash_ ^= Zobrist::PIECE[Them][PAWN][capSq];
+                removePiece(Them, PAWN, capSq);
             }
             
             if (mt == MT_PROMOTION) {
-                hash_ ^= Zobrist::PIECE[us][PAWN][from];
-                hash_ ^= Zobrist::PIECE[us][m.promo()][to];
-                removePiece(us, PAWN, from);
-                putPiece(us, m.promo(), to);
+                hash_ ^= Zobrist::PIECE[Us][PAWN][from];
+                hash_ ^= Zobrist::PIECE[Us][m.promo()][to];
+                removePiece(Us, PAWN, from);
+                putPiece(Us, m.promo(), to);
             } else {
-                hash_ ^= Zobrist::PIECE[us][moving][from];
-                hash_ ^= Zobrist::PIECE[us][moving][to];
-                movePiece(us, moving, from, to);
+                hash_ ^= Zobrist::PIECE[Us][moving][from];
+                hash_ ^= Zobrist::PIECE[Us][moving][to];
+                movePiece(Us, moving, from, to);
                 
-                if (moving == PAWN && std::abs(to - from) == 16) {
+                if (moving == PAWN && to - from == Up + Up) {
                     epSquare_ = (from + to) / 2;
                 }
             }
@@ -296,57 +465,49 @@ public:
         
         // Flip side
         hash_ ^= Zobrist::SIDE;
-        sideToMove_ = them;
-        fullmove_ += (us == BLACK);
-        
-        return undo;
+        sideToMove_ = Them;
+        updateCheckInfo<Them>();
     }
     
-    void unmakeMove(Move m, UndoInfo undo) {
-        if (undo.isInvalid()) {
-            if (!history_.empty()) history_.pop_back();
-            return;
-        }
-        // Restore hash from history
-        hash_ = history_.back();
-        history_.pop_back();
+    template<Color Us>
+    void unmakeMove(Move m) {
+        constexpr Color Them = ~Us;
+        constexpr int Up = Us == WHITE ? NORTH : SOUTH;
+        const StateInfo& st = popState();
+        hash_ = st.key;
         
-        sideToMove_ = ~sideToMove_;
-        Color us = sideToMove_;
-        Color them = ~us;
+        sideToMove_ = Us;
         int from = m.from(), to = m.to();
         MoveType mt = m.type();
         
-        fullmove_ -= (us == BLACK);
-        castling_ = undo.castling();
-        epSquare_ = undo.ep();
-        halfmove_ = undo.halfmove();
+        castling_ = st.castling;
+        epSquare_ = st.ep;
+        halfmove_ = st.halfmove;
+        checkInfo_ = st.checkInfo;
         
         if (mt == MT_CASTLING) {
-            int side = (fileOf(to) == 6) ? 0 : 1;
-            int idx = us * 2 + side;
-            movePiece(us, KING, to, from);
-            movePiece(us, ROOK, Tables::CASTLING_ROOK_TO[idx], Tables::CASTLING_ROOK_FROM[idx]);
+            int idx = Us * 2 + (fileOf(to) == 6 ? 0 : 1);
+            movePiece(Us, KING, to, from);
+            movePiece(Us, ROOK, Tables::CASTLING_ROOK_TO[idx], Tables::CASTLING_ROOK_FROM[idx]);
         } else {
             if (mt == MT_PROMOTION) {
-                removePiece(us, m.promo(), to);
-                putPiece(us, PAWN, from);
+                removePiece(Us, m.promo(), to);
+                putPiece(Us, PAWN, from);
             } else {
-                movePiece(us, pieceAt(to), to, from);
+                movePiece(Us, pieceAt(to), to, from);
             }
             
             if (mt == MT_EN_PASSANT) {
-                int capSq = to + (us == WHITE ? -8 : 8);
-                putPiece(them, PAWN, capSq);
-            } else if (undo.captured() != NO_PIECE) {
-                putPiece(them, undo.captured(), to);
+                putPiece(Them, PAWN, to - Up);
+            } else if (st.captured != NO_PIECE) {
+                putPiece(Them, st.captured, to);
             }
         }
     }
 
     // Null move (for search pruning)
-    NullUndo makeNullMove() {
-        NullUndo u{epSquare_, halfmove_, castling_};
+    void makeNullMove() {
+        pushState(NO_PIECE);
 
         // Update hash for null move
         if (epSquare_ >= 0) hash_ ^= Zobrist::EP[epSquare_ & 7];
@@ -355,59 +516,148 @@ public:
         epSquare_ = -1;
         halfmove_ = 0;
         sideToMove_ = ~sideToMove_;
-        return u;
+        updateCheckInfo();
     }
 
-    void unmakeNullMove(NullUndo u) {
-        // Restore hash
-        hash_ ^= Zobrist::SIDE;
-        if (u.ep >= 0) hash_ ^= Zobrist::EP[u.ep & 7];
-
+    void unmakeNullMove() {
+        const StateInfo& st = popState();
+        hash_ = st.key;
         sideToMove_ = ~sideToMove_;
-        epSquare_ = u.ep;
-        halfmove_ = u.halfmove;
-        castling_ = u.castling;
+        epSquare_ = st.ep;
+        halfmove_ = st.halfmove;
+        castling_ = st.castling;
+        checkInfo_ = st.checkInfo;
     }
 
     //========================================================================
     // OPTIMIZATION 12: Fast legal move generation with pin detection
     //========================================================================
-    void generateLegalMoves(MoveList& moves) {
-        moves.clear();
-        
+    void generateLegalMoves(MoveList& moves) { generateMoves<true>(moves); }
+
+    // Pseudo-legal: check evasions are respected, but pins, king destinations
+    // and en passant are left to isLegal() so the search only pays for moves it reaches
+    void generatePseudoLegalMoves(MoveList& moves) { generateMoves<false>(moves); }
+
+    // Number of legal moves, without writing them anywhere
+    int countLegalMoves() {
+        MoveCounter counter;
+        generateMoves<true>(counter);
+        return counter.size();
+    }
+
+    // Our pieces that are the only blocker between our king and an enemy slider
+    FORCE_INLINE Bitboard pinnedPieces() const { return checkInfo_.pinned; }
+
+    // Legality of a move from generatePseudoLegalMoves, given pinnedPieces()
+    FORCE_INLINE bool isLegal(Move m, Bitboard pinned) const {
         Color us = sideToMove_;
         Color them = ~us;
+        int from = m.from(), to = m.to();
         int ksq = kingSq(us);
+
+        if (UNLIKELY(m.type() == MT_EN_PASSANT)) {
+            // Two pieces leave the king's lines at once: recheck everything
+            int capSq = to + (us == WHITE ? -8 : 8);
+            Bitboard occ = (occupied_ ^ squareBB(from) ^ squareBB(capSq)) | squareBB(to);
+            return !(attackersTo(ksq, occ, them) & ~squareBB(capSq));
+        }
+        if (m.type() == MT_CASTLING) return true;  // Path and check already verified
+        if (from == ksq) return !attackersTo(to, occupied_ ^ squareBB(ksq), them);
+        return !(pinned & squareBB(from)) || (Tables::LINE_BB[ksq][from] & squareBB(to));
+    }
+    
+    // Whether a move from anywhere (a GUI, an old hash entry) is one that
+    // generatePseudoLegalMoves would produce here; isLegal() finishes the job
+    bool isPseudoLegal(Move m) const {
+        Color us = sideToMove_;
+        Color them = ~us;
+        int from = m.from(), to = m.to();
+        if (m.isNull() || isEmpty(from) || colorAt(from) != us) return false;
+
+        PieceType pt = pieceAt(from);
+        MoveType mt = m.type();
+        Bitboard toBB = squareBB(to);
+        int ksq = kingSq(us);
+
+        if (mt == MT_CASTLING) {
+            // Same conditions as generateCastling
+            int home = us == WHITE ? 4 : 60;
+            if (pt != KING || from != home || inCheck()) return false;
+            if (to == home + 2)
+                return (castling_ & (us == WHITE ? WHITE_OO : BLACK_OO))
+                    && !(occupied_ & (squareBB(home + 1) | squareBB(home + 2)))
+                    && !isAttacked(home + 1, them) && !isAttacked(home + 2, them);
+            if (to == home - 2)
+                return (castling_ & (us == WHITE ? WHITE_OOO : BLACK_OOO))
+                    && !(occupied_ & (squareBB(home - 1) | squareBB(home - 2) | squareBB(home - 3)))
+                    && !isAttacked(home - 1, them) && !isAttacked(home - 2, them);
+            return false;
+        }
+
+        // isLegal() checks en passant against every line through the king
+        if (mt == MT_EN_PASSANT)
+            return pt == PAWN && to == epSquare_ && (Tables::PAWN_ATTACKS[us][from] & toBB);
+
+        if (byColor_[us] & toBB) return false;
+
+        if (pt == PAWN) {
+            int up = us == WHITE ? NORTH : SOUTH;
+            bool lastRank = rankOf(to) == (us == WHITE ? 7 : 0);
+            if (lastRank != (mt == MT_PROMOTION)) return false;
+            bool capture = Tables::PAWN_ATTACKS[us][from] & byColor_[them] & toBB;
+            bool push = to == from + up && isEmpty(to);
+            bool doublePush = to == from + 2 * up && rankOf(from) == (us == WHITE ? 1 : 6)
+                           && isEmpty(from + up) && isEmpty(to);
+            if (!capture && !push && !doublePush) return false;
+        } else {
+            if (mt != MT_NORMAL) return false;
+            Bitboard attacks = pt == KNIGHT ? Tables::KNIGHT_ATTACKS[from]
+                             : pt == BISHOP ? bishopAttacks(from, occupied_)
+                             : pt == ROOK ? rookAttacks(from, occupied_)
+                             : pt == QUEEN ? queenAttacks(from, occupied_)
+                             : Tables::KING_ATTACKS[from];
+            if (!(attacks & toBB)) return false;
+        }
+
+        // Other pieces must answer a check, as the generator's targetMask does
+        Bitboard checkersBB = checkers();
+        if (pt != KING && checkersBB) {
+            if (popCount(checkersBB) > 1) return false;
+            if (!((Tables::BETWEEN_BB[ksq][lsb(checkersBB)] | checkersBB) & toBB)) return false;
+        }
+        return true;
+    }
+
+private:
+    // The one colour dispatch; below it every direction, rank mask and
+    // castling square is a compile-time constant
+    template<bool Legal, typename List>
+    void generateMoves(List& moves) {
+        moves.clear();
+        if (sideToMove_ == WHITE) generateMovesFor<WHITE, Legal>(moves);
+        else generateMovesFor<BLACK, Legal>(moves);
+    }
+
+    template<Color Us, bool Legal, typename List>
+    void generateMovesFor(List& moves) {
+        constexpr Color Them = ~Us;
+        int ksq = kingSq(Us);
         Bitboard checkersBB = checkers();
         int numCheckers = popCount(checkersBB);
         
-        // OPTIMIZATION: Precompute pins
-        Bitboard pinned = 0;
-        
-        // FIX: Mask out our own pieces to see "through" them for pinners
-        Bitboard occNoUs = occupied_ ^ byColor_[us];
-        
-        Bitboard pinners = ((rookAttacks(ksq, occNoUs) & (pieces_[them][ROOK] | pieces_[them][QUEEN]))
-                          | (bishopAttacks(ksq, occNoUs) & (pieces_[them][BISHOP] | pieces_[them][QUEEN])));
-        
-        while (pinners) {
-            int pinner = popLSB(pinners);
-            Bitboard between = Tables::BETWEEN_BB[ksq][pinner] & occupied_;
-            // A piece is pinned if it is the ONLY thing between King and Pinner
-            if (popCount(between) == 1) {
-                pinned |= between & byColor_[us];
-            }
-        }
+        // OPTIMIZATION: Pins come from the cached check info
+        Bitboard pinned = Legal ? pinnedPieces() : 0;
         
         // King moves - always generated
-        Bitboard kingMoves = Tables::KING_ATTACKS[ksq] & ~byColor_[us];
+        Bitboard kingMoves = Tables::KING_ATTACKS[ksq] & ~byColor_[Us];
         while (kingMoves) {
             int to = popLSB(kingMoves);
             // Must check if destination is attacked (king moved away)
-            Bitboard newOcc = (occupied_ ^ squareBB(ksq)) | squareBB(to);
-            if (!attackersTo(to, newOcc, them)) {
-                moves.push(Move(ksq, to));
+            if constexpr (Legal) {
+                Bitboard newOcc = (occupied_ ^ squareBB(ksq)) | squareBB(to);
+                if (attackersTo(to, newOcc, Them)) continue;
             }
+            moves.push(Move(ksq, to));
         }
         
         // If double check, only king moves are legal
@@ -421,38 +671,38 @@ public:
         }
         
         // Generate non-king moves
-        generatePieceMoves<PAWN>(moves, us, them, ksq, pinned, targetMask);
-        generatePieceMoves<KNIGHT>(moves, us, them, ksq, pinned, targetMask);
-        generatePieceMoves<BISHOP>(moves, us, them, ksq, pinned, targetMask);
-        generatePieceMoves<ROOK>(moves, us, them, ksq, pinned, targetMask);
-        generatePieceMoves<QUEEN>(moves, us, them, ksq, pinned, targetMask);
+        generatePawnMoves<Us>(moves, ksq, pinned, targetMask);
+        generatePieceMoves<Us, KNIGHT>(moves, ksq, pinned, targetMask);
+        generatePieceMoves<Us, BISHOP>(moves, ksq, pinned, targetMask);
+        generatePieceMoves<Us, ROOK>(moves, ksq, pinned, targetMask);
+        generatePieceMoves<Us, QUEEN>(moves, ksq, pinned, targetMask);
         
         // Castling - only if not in check
         if (numCheckers == 0) {
-            generateCastling(moves, us, them);
+            generateCastling<Us>(moves);
         }
         
         // En passant
         if (epSquare_ >= 0) {
-            generateEnPassant(moves, us, them);
+            if constexpr (Legal) {
+                generateEnPassant<Us>(moves);
+            } else {
+                Bitboard pawns = pieces_[Us][PAWN] & Tables::PAWN_ATTACKS[Them][epSquare_];
+                while (pawns) moves.push(Move(popLSB(pawns), epSquare_, MT_EN_PASSANT));
+            }
         }
     }
     
-private:
-    template<PieceType PT>
-    void generatePieceMoves(MoveList& moves, Color us, Color them, int ksq, 
-                            Bitboard pinned, Bitboard targetMask) {
-        Bitboard pcs = pieces_[us][PT];
+    template<Color Us, PieceType PT, typename List>
+    void generatePieceMoves(List& moves, int ksq, Bitboard pinned, Bitboard targetMask) {
+        Bitboard pcs = pieces_[Us][PT];
         
         while (pcs) {
             int from = popLSB(pcs);
             bool isPinned = pinned & squareBB(from);
             
             Bitboard attacks;
-            if constexpr (PT == PAWN) {
-                generatePawnMoves(moves, from, us, them, ksq, isPinned, targetMask);
-                continue;
-            } else if constexpr (PT == KNIGHT) {
+            if constexpr (PT == KNIGHT) {
                 if (isPinned) continue;  // Pinned knight can never move
                 attacks = Tables::KNIGHT_ATTACKS[from];
             } else if constexpr (PT == BISHOP) {
@@ -463,116 +713,131 @@ private:
                 attacks = queenAttacks(from, occupied_);
             }
             
-            attacks &= ~byColor_[us] & targetMask;
+            attacks &= ~byColor_[Us] & targetMask;
             
             // If pinned, can only move along pin ray
             if (isPinned) {
                 attacks &= Tables::LINE_BB[ksq][from];
             }
             
-            while (attacks) {
-                moves.push(Move(from, popLSB(attacks)));
-            }
+            pushTargets(moves, from, attacks);
         }
     }
     
-    void generatePawnMoves(MoveList& moves, int from, Color us, Color them, int ksq,
-                           bool isPinned, Bitboard targetMask) {
-        int forward = us == WHITE ? 8 : -8;
-        int startRank = us == WHITE ? 1 : 6;
-        int promoRank = us == WHITE ? 6 : 1;
-        int rank = rankOf(from);
-        
-        Bitboard pinRay = isPinned ? Tables::LINE_BB[ksq][from] : ~0ULL;
-        
-        // Forward push
-        int to = from + forward;
-        
-        // General requirements for any push: Dest empty, and must stay on pin ray (vertical)
-        if (isEmpty(to) && (squareBB(to) & pinRay)) {
-            
-            // Single push validity: Must satisfy targetMask (block check)
-            if (squareBB(to) & targetMask) {
-                if (rank == promoRank) {
-                    moves.push(Move(from, to, MT_PROMOTION, QUEEN));
-                    moves.push(Move(from, to, MT_PROMOTION, ROOK));
-                    moves.push(Move(from, to, MT_PROMOTION, BISHOP));
-                    moves.push(Move(from, to, MT_PROMOTION, KNIGHT));
-                } else {
-                    moves.push(Move(from, to));
-                }
-            }
-            
-            // Double push validity
-            // FIX: Decoupled from single push targetMask check. 
-            // The intermediate square `to` does NOT need to block the check, only `to2` does.
-            if (rank == startRank) {
-                int to2 = to + forward;
-                if (isEmpty(to2) && (squareBB(to2) & targetMask) && (squareBB(to2) & pinRay)) {
-                    moves.push(Move(from, to2));
-                }
-            }
+    // OPTIMIZATION: Set-wise pawn generation - all unpinned pawns at once with
+    // shifts; pinned pawns go through the same path one by one, limited to their pin ray
+    template<Color Us, typename List>
+    void generatePawnMoves(List& moves, int ksq, Bitboard pinned, Bitboard targetMask) {
+        Bitboard pawns = pieces_[Us][PAWN];
+        generatePawnSet<Us>(moves, pawns & ~pinned, targetMask);
+
+        Bitboard pinnedPawns = pawns & pinned;
+        while (pinnedPawns) {
+            int from = popLSB(pinnedPawns);
+            generatePawnSet<Us>(moves, squareBB(from), targetMask & Tables::LINE_BB[ksq][from],
+                                Tables::LINE_BB[ksq][from]);
         }
-        
+    }
+
+    template<Color Us, typename List>
+    void generatePawnSet(List& moves, Bitboard pawns, Bitboard targetMask, Bitboard pinRay = ~0ULL) {
+        constexpr int Up = Us == WHITE ? NORTH : SOUTH;
+        constexpr int UpWest = Us == WHITE ? NORTH_WEST : SOUTH_WEST;
+        constexpr int UpEast = Us == WHITE ? NORTH_EAST : SOUTH_EAST;
+        constexpr Bitboard PromoFrom = Us == WHITE ? RANK_7 : RANK_2;
+        constexpr Bitboard DoubleVia = Us == WHITE ? RANK_3 : RANK_6;
+
+        const Bitboard empty = ~occupied_;
+        const Bitboard enemies = byColor_[~Us] & targetMask;
+        const Bitboard promoPawns = pawns & PromoFrom;
+        const Bitboard otherPawns = pawns & ~PromoFrom;
+
+        // Pushes: the intermediate square of a double push need not block a check,
+        // only the destination does, so single pushes are masked late
+        Bitboard single = shift<Up>(otherPawns) & empty & pinRay;
+        Bitboard dbl = shift<Up>(single & DoubleVia) & empty & targetMask;
+        single &= targetMask;
+        pushPawnTargets<Up>(moves, single);
+        pushPawnTargets<Up + Up>(moves, dbl);
+
         // Captures
-        Bitboard attacks = Tables::PAWN_ATTACKS[us][from] & byColor_[them] & targetMask & pinRay;
-        while (attacks) {
-            int capSq = popLSB(attacks);
-            if (rank == promoRank) {
-                moves.push(Move(from, capSq, MT_PROMOTION, QUEEN));
-                moves.push(Move(from, capSq, MT_PROMOTION, ROOK));
-                moves.push(Move(from, capSq, MT_PROMOTION, BISHOP));
-                moves.push(Move(from, capSq, MT_PROMOTION, KNIGHT));
-            } else {
-                moves.push(Move(from, capSq));
+        Bitboard west = shift<UpWest>(otherPawns) & enemies;
+        Bitboard east = shift<UpEast>(otherPawns) & enemies;
+        pushPawnTargets<UpWest>(moves, west);
+        pushPawnTargets<UpEast>(moves, east);
+
+        // Promotions (pushes and captures)
+        if (promoPawns) {
+            Bitboard push = shift<Up>(promoPawns) & empty & targetMask;
+            Bitboard capW = shift<UpWest>(promoPawns) & enemies;
+            Bitboard capE = shift<UpEast>(promoPawns) & enemies;
+            pushPromotions<UpWest>(moves, capW);
+            pushPromotions<UpEast>(moves, capE);
+            pushPromotions<Up>(moves, push);
+        }
+    }
+
+    // Appending a target set; a MoveCounter only needs its size
+    template<typename List>
+    FORCE_INLINE static void pushTargets(List& moves, int from, Bitboard targets) {
+        if constexpr (std::is_same_v<List, MoveCounter>) moves.add(popCount(targets));
+        else while (targets) moves.push(Move(from, popLSB(targets)));
+    }
+
+    template<int Dir, typename List>
+    FORCE_INLINE static void pushPawnTargets(List& moves, Bitboard targets) {
+        if constexpr (std::is_same_v<List, MoveCounter>) moves.add(popCount(targets));
+        else while (targets) { int to = popLSB(targets); moves.push(Move(to - Dir, to)); }
+    }
+
+    template<int Dir, typename List>
+    FORCE_INLINE static void pushPromotions(List& moves, Bitboard targets) {
+        if constexpr (std::is_same_v<List, MoveCounter>) {
+            moves.add(4 * popCount(targets));
+        } else {
+            while (targets) {
+                int to = popLSB(targets), from = to - Dir;
+                moves.push(Move(from, to, MT_PROMOTION, QUEEN));
+                moves.push(Move(from, to, MT_PROMOTION, ROOK));
+                moves.push(Move(from, to, MT_PROMOTION, BISHOP));
+                moves.push(Move(from, to, MT_PROMOTION, KNIGHT));
             }
         }
     }
     
-    void generateEnPassant(MoveList& moves, Color us, Color them) {
+    template<Color Us, typename List>
+    void generateEnPassant(List& moves) {
         if (epSquare_ < 0) return;
     
         // Pawns that could capture en passant
-        Bitboard pawns = pieces_[us][PAWN] & Tables::PAWN_ATTACKS[them][epSquare_];
+        Bitboard pawns = pieces_[Us][PAWN] & Tables::PAWN_ATTACKS[~Us][epSquare_];
     
         while (pawns) {
-            int from = popLSB(pawns);
-    
-            Move m(from, epSquare_, MT_EN_PASSANT);
-            UndoInfo u = makeMove(m);
-    
-            // After makeMove, sideToMove_ == them.
-            // We want to know if *our* king (us) is in check.
-            bool legal = !isAttacked(kingSq(us), them);
-    
-            unmakeMove(m, u);
-    
-            if (legal)
-                moves.push(m);
+            Move m(popLSB(pawns), epSquare_, MT_EN_PASSANT);
+            // isLegal rechecks both vacated squares without a make/unmake
+            if (isLegal(m, 0)) moves.push(m);
         }
     }
     
-    void generateCastling(MoveList& moves, Color us, Color them) {
-        int ksq = us == WHITE ? 4 : 60;
+    template<Color Us, typename List>
+    void generateCastling(List& moves) {
+        constexpr Color Them = ~Us;
+        constexpr int ksq = Us == WHITE ? 4 : 60;
+        constexpr CastlingRights OO = Us == WHITE ? WHITE_OO : BLACK_OO;
+        constexpr CastlingRights OOO = Us == WHITE ? WHITE_OOO : BLACK_OOO;
+        constexpr Bitboard OOPath = squareBB(ksq + 1) | squareBB(ksq + 2);
+        constexpr Bitboard OOOPath = squareBB(ksq - 1) | squareBB(ksq - 2) | squareBB(ksq - 3);
         
         // Kingside
-        CastlingRights oo = us == WHITE ? WHITE_OO : BLACK_OO;
-        if (castling_ & oo) {
-            int f1 = ksq + 1, g1 = ksq + 2;
-            if (isEmpty(f1) && isEmpty(g1) &&
-                !isAttacked(f1, them) && !isAttacked(g1, them)) {
-                moves.push(Move(ksq, g1, MT_CASTLING));
-            }
+        if ((castling_ & OO) && !(occupied_ & OOPath) &&
+            !isAttacked(ksq + 1, Them) && !isAttacked(ksq + 2, Them)) {
+            moves.push(Move(ksq, ksq + 2, MT_CASTLING));
         }
         
         // Queenside
-        CastlingRights ooo = us == WHITE ? WHITE_OOO : BLACK_OOO;
-        if (castling_ & ooo) {
-            int d1 = ksq - 1, c1 = ksq - 2, b1 = ksq - 3;
-            if (isEmpty(d1) && isEmpty(c1) && isEmpty(b1) &&
-                !isAttacked(d1, them) && !isAttacked(c1, them)) {
-                moves.push(Move(ksq, c1, MT_CASTLING));
-            }
+        if ((castling_ & OOO) && !(occupied_ & OOOPath) &&
+            !isAttacked(ksq - 1, Them) && !isAttacked(ksq - 2, Them)) {
+            moves.push(Move(ksq, ksq - 2, MT_CASTLING));
         }
     }
 
@@ -580,70 +845,193 @@ public:
     //========================================================================
     // FEN parsing/output
     //========================================================================
-    bool setFEN(const std::string& fen) {
-        clear();
-        std::istringstream ss(fen);
-        std::string pieces, side, castling, ep;
-        int hm = 0, fm = 1;
-        ss >> pieces >> side >> castling >> ep >> hm >> fm;
-        
-        int sq = 56;
-        for (char c : pieces) {
-            if (c == '/') sq -= 16;
-            else if (c >= '1' && c <= '8') sq += c - '0';
-            else {
-                Color col = std::isupper(c) ? WHITE : BLACK;
-                PieceType pt = charToPT(c);
-                if (pt != NO_PIECE && sq >= 0 && sq < 64) putPiece(col, pt, sq++);
+    // OPTIMIZATION: Allocation-free FEN parsing. The position is validated
+    // in full before anything is written, so on error the board is unchanged.
+    // The move counters are optional (EPD-style input).
+    FenError parseFEN(std::string_view fen) {
+        size_t i = 0, n = fen.size();
+        auto field = [&]() {
+            while (i < n && fen[i] == ' ') ++i;
+            size_t begin = i;
+            while (i < n && fen[i] != ' ') ++i;
+            return fen.substr(begin, i - begin);
+        };
+
+        // Piece placement: one branch-free pass per character fills the
+        // mailbox, the piece bitboards and the piece part of the hash. pos
+        // counts squares in FEN order (a8 = 0); instead of per-character
+        // checks, the position of every '/' is recorded and must close a full
+        // rank. Bad characters cover 9 squares, so they always break that.
+        std::uint8_t box[64];
+        std::memset(box, 0xFF, sizeof(box));
+        Bitboard byCode[16] = {};  // [mailbox byte & 15]; slot 15 gets non-pieces
+        int slashAt[16];           // slashAt[i]: pos at the i-th '/'; [0] is scratch
+        const std::uint64_t* keys = Zobrist::PIECE[0][0].data();  // Same [code & 15][sq] layout
+        std::uint64_t key = 0;
+        std::string_view placement = field();
+        int pos = 0, slashes = 0;
+        for (char c : placement) {
+            unsigned k = std::uint8_t(c);
+            int slash = c == '/';
+            slashes += slash;
+            slashAt[slash ? slashes & 15 : 0] = pos;
+            int sq = (pos ^ 56) & 63;
+            unsigned code = FEN_CHAR_CODE[k];
+            box[sq] = std::uint8_t(code);
+            byCode[code & 15] |= squareBB(sq);
+            key ^= keys[(code & 15) * 64 + sq];
+            pos += FEN_CHAR_ADVANCE[k];
+        }
+        if (slashes != 7 || pos != 64) return FenError::Placement;
+        for (int r = 1; r <= 7; ++r)
+            if (slashAt[r] != 8 * r) return FenError::Placement;
+        Bitboard pcs[2][6];
+        for (int c = 0; c < 2; ++c)
+            for (int pt = PAWN; pt <= KING; ++pt) pcs[c][pt] = byCode[c << 3 | pt];
+        if (popCount(pcs[WHITE][KING]) != 1 || popCount(pcs[BLACK][KING]) != 1) return FenError::KingCount;
+        if ((pcs[WHITE][PAWN] | pcs[BLACK][PAWN]) & (RANK_1 | RANK_8)) return FenError::PawnOnBackRank;
+
+        // Side to move
+        std::string_view side = field();
+        if (side != "w" && side != "b") return FenError::SideToMove;
+        Color us = side == "w" ? WHITE : BLACK;
+
+        // Castling: each right at most once, king and rook on their home squares
+        std::string_view castle = field();
+        CastlingRights rights = NO_CASTLING;
+        if (castle != "-") {
+            if (castle.empty()) return FenError::Castling;
+            for (char c : castle) {
+                CastlingRights r; Color col; int rookSq;
+                switch (c) {
+                    case 'K': r = WHITE_OO;  col = WHITE; rookSq = 7;  break;
+                    case 'Q': r = WHITE_OOO; col = WHITE; rookSq = 0;  break;
+                    case 'k': r = BLACK_OO;  col = BLACK; rookSq = 63; break;
+                    case 'q': r = BLACK_OOO; col = BLACK; rookSq = 56; break;
+                    default: return FenError::Castling;
+                }
+                int kingSq = col == WHITE ? 4 : 60;
+                if ((rights & r) || box[kingSq] != (KING | (col << 3)) || box[rookSq] != (ROOK | (col << 3)))
+                    return FenError::Castling;
+                rights = rights | r;
             }
         }
-        
-        sideToMove_ = (side == "b") ? BLACK : WHITE;
-        
-        castling_ = NO_CASTLING;
-        for (char c : castling) {
-            if (c == 'K') castling_ = castling_ | WHITE_OO;
-            if (c == 'Q') castling_ = castling_ | WHITE_OOO;
-            if (c == 'k') castling_ = castling_ | BLACK_OO;
-            if (c == 'q') castling_ = castling_ | BLACK_OOO;
+
+        // En passant: the square a pawn of the side not to move just skipped
+        std::string_view ep = field();
+        int epSq = -1;
+        if (ep != "-") {
+            if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h') return FenError::EnPassant;
+            if (ep[1] != (us == WHITE ? '6' : '3')) return FenError::EnPassant;
+            epSq = (ep[1] - '1') * 8 + (ep[0] - 'a');
+            int pawnSq = us == WHITE ? epSq - 8 : epSq + 8;
+            int fromSq = us == WHITE ? epSq + 8 : epSq - 8;
+            if (box[epSq] != 0xFF || box[fromSq] != 0xFF || box[pawnSq] != std::uint8_t(PAWN | (~us << 3)))
+                return FenError::EnPassant;
         }
-        
-        epSquare_ = strToSq(ep);
-        halfmove_ = hm;
-        fullmove_ = fm;
-        
-        // Initialize hash after setting up the position
-        hash_ = computeHash();
-        history_.clear();  // Clear history when setting new position
-        
-        return true;
+
+        // Move counters
+        auto number = [](std::string_view t, unsigned limit, unsigned& out) {
+            if (t.empty() || t.size() > 5) return false;
+            unsigned v = 0;
+            for (char c : t) {
+                if (c < '0' || c > '9') return false;
+                v = v * 10 + unsigned(c - '0');
+            }
+            out = v;
+            return v <= limit;
+        };
+        unsigned hm = 0, fm = 1;
+        std::string_view hmField = field(), fmField = field();
+        if (!hmField.empty() && !number(hmField, 255, hm)) return FenError::Clock;
+        if (!fmField.empty() && !number(fmField, 65535, fm)) return FenError::Clock;
+        if (!field().empty()) return FenError::TrailingData;
+
+        // The side that just moved cannot have left its king in check
+        Bitboard occ = 0;
+        for (int pt = PAWN; pt <= KING; ++pt) occ |= pcs[WHITE][pt] | pcs[BLACK][pt];
+        int theirKing = lsb(pcs[~us][KING]);
+        if ((Tables::PAWN_ATTACKS[~us][theirKing] & pcs[us][PAWN])
+            | (Tables::KNIGHT_ATTACKS[theirKing] & pcs[us][KNIGHT])
+            | (Tables::KING_ATTACKS[theirKing] & pcs[us][KING])
+            | (rookAttacks(theirKing, occ) & (pcs[us][ROOK] | pcs[us][QUEEN]))
+            | (bishopAttacks(theirKing, occ) & (pcs[us][BISHOP] | pcs[us][QUEEN])))
+            return FenError::OpponentInCheck;
+
+        // Commit
+        std::memcpy(pieces_, pcs, sizeof(pieces_));
+        std::memcpy(mailbox_, box, sizeof(mailbox_));
+        for (int c = 0; c < 2; ++c) {
+            byColor_[c] = 0;
+            for (int pt = PAWN; pt <= KING; ++pt) byColor_[c] |= pcs[c][pt];
+            kingSquare_[c] = std::uint8_t(lsb(pcs[c][KING]));
+        }
+        occupied_ = occ;
+        sideToMove_ = us;
+        castling_ = rights;
+        epSquare_ = std::int8_t(epSq);
+        halfmove_ = std::uint8_t(hm);
+        startFullmove_ = std::uint16_t(fm ? fm : 1);
+        startSide_ = us;
+        key ^= Zobrist::CASTLING[rights];
+        if (epSq >= 0) key ^= Zobrist::EP[epSq & 7];
+        if (us == BLACK) key ^= Zobrist::SIDE;
+        hash_ = key;
+        assert(hash_ == computeHash());
+        stateCount_ = 0;  // Clear history when setting new position
+        updateCheckInfo();
+        return FenError::None;
     }
-    
-    std::string toFEN() const {
-        std::string fen;
+
+    bool setFEN(std::string_view fen) { return parseFEN(fen) == FenError::None; }
+
+    // Writes the FEN and a terminating NUL into out (FEN_BUFFER_SIZE bytes);
+    // returns its length
+    int writeFEN(char* out) const {
+        char* p = out;
         for (int r = 7; r >= 0; --r) {
             int empty = 0;
             for (int f = 0; f < 8; ++f) {
                 int sq = r * 8 + f;
                 if (isEmpty(sq)) { ++empty; continue; }
-                if (empty) { fen += char('0' + empty); empty = 0; }
-                fen += ptToChar(pieceAt(sq), colorAt(sq));
+                if (empty) { *p++ = char('0' + empty); empty = 0; }
+                *p++ = ptToChar(pieceAt(sq), colorAt(sq));
             }
-            if (empty) fen += char('0' + empty);
-            if (r > 0) fen += '/';
-        }
-        fen += sideToMove_ == WHITE ? " w " : " b ";
-        if (castling_ == NO_CASTLING) fen += '-';
-        else {
-            if (castling_ & WHITE_OO) fen += 'K';
-            if (castling_ & WHITE_OOO) fen += 'Q';
-            if (castling_ & BLACK_OO) fen += 'k';
-            if (castling_ & BLACK_OOO) fen += 'q';
-        }
-        fen += ' ';
-        fen += epSquare_ >= 0 ? sqStr(epSquare_) : "-";
-        fen += ' ' + std::to_string(halfmove_) + ' ' + std::to_string(fullmove_);
-        return fen;
+            if (empty) *p++ = char('0' + empty);
+            if (r > 0) *p++ = '/';
+        }
+        *p++ = ' ';
+        *p++ = sideToMove_ == WHITE ? 'w' : 'b';
+        *p++ = ' ';
+        if (castling_ == NO_CASTLING) *p++ = '-';
+        if (castling_ & WHITE_OO) *p++ = 'K';
+        if (castling_ & WHITE_OOO) *p++ = 'Q';
+        if (castling_ & BLACK_OO) *p++ = 'k';
+        if (castling_ & BLACK_OOO) *p++ = 'q';
+        *p++ = ' ';
+        if (epSquare_ >= 0) {
+            *p++ = char('a' + fileOf(epSquare_));
+            *p++ = char('1' + rankOf(epSquare_));
+        } else {
+            *p++ = '-';
+        }
+        auto number = [&p](unsigned v) {
+            char digits[5];
+            int k = 0;
+            do { digits[k++] = char('0' + v % 10); v /= 10; } while (v);
+            while (k) *p++ = digits[--k];
+        };
+        *p++ = ' ';
+        number(halfmove_);
+        *p++ = ' ';
+        number(fullmove());
+        *p = '\0';
+        return int(p - out);
+    }
+
+    std::string toFEN() const {
+        char buf[FEN_BUFFER_SIZE];
+        return std::string(buf, writeFEN(buf));
     }
     
     void reset() { setFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"); }
@@ -651,27 +1039,28 @@ public:
     //========================================================================
     // Move parsing
     //========================================================================
-    std::optional<Move> parseUCI(const std::string& s) {
+    // OPTIMIZATION: The move type comes from the board, then one
+    // isPseudoLegal/isLegal check replaces generating every legal move
+    std::optional<Move> parseUCI(const std::string& s) const {
         if (s.length() < 4) return std::nullopt;
         int from = strToSq(s.substr(0, 2));
         int to = strToSq(s.substr(2, 2));
-        if (from < 0 || to < 0) return std::nullopt;
-        
-        MoveList moves;
-        generateLegalMoves(moves);
-        
-        PieceType promo = s.length() >= 5 ? charToPT(s[4]) : NO_PIECE;
-        
-        for (Move m : moves) {
-            if (m.from() == from && m.to() == to) {
-                if (m.type() == MT_PROMOTION) {
-                    if (m.promo() == promo) return m;
-                } else {
-                    return m;
-                }
-            }
+        if (from < 0 || to < 0 || isEmpty(from)) return std::nullopt;
+
+        PieceType pt = pieceAt(from);
+        Move m(from, to);
+        if (pt == KING && std::abs(to - from) == 2) {
+            m = Move(from, to, MT_CASTLING);
+        } else if (pt == PAWN && to == epSquare_ && fileOf(from) != fileOf(to)) {
+            m = Move(from, to, MT_EN_PASSANT);
+        } else if (pt == PAWN && (rankOf(to) == 0 || rankOf(to) == 7)) {
+            PieceType promo = s.length() >= 5 ? charToPT(s[4]) : NO_PIECE;
+            if (promo < KNIGHT || promo > QUEEN) return std::nullopt;
+            m = Move(from, to, MT_PROMOTION, promo);
         }
-        return std::nullopt;
+
+        if (!isPseudoLegal(m) || !isLegal(m, pinnedPieces())) return std::nullopt;
+        return m;
     }
     
     std::string moveToUCI(Move m) const {
@@ -683,11 +1072,131 @@ public:
     //========================================================================
     // Game state
     //========================================================================
-    bool isCheckmate() { MoveList m; generateLegalMoves(m); return m.size() == 0 && inCheck(); }
-    bool isStalemate() { MoveList m; generateLegalMoves(m); return m.size() == 0 && !inCheck(); }
+    enum class GameState : std::uint8_t {
+        Ongoing, Checkmate, Stalemate, FiftyMoves, Repetition, InsufficientMaterial
+    };
+
+    // Everything a game loop needs after a move, from one move count.
+    // Mate takes precedence over the fifty-move rule.
+    GameState gameState() {
+        if (countLegalMoves() == 0) return inCheck() ? GameState::Checkmate : GameState::Stalemate;
+        if (halfmove_ >= 100) return GameState::FiftyMoves;
+        if (isRepetition()) return GameState::Repetition;
+        if (isInsufficientMaterial()) return GameState::InsufficientMaterial;
+        return GameState::Ongoing;
+    }
+
+    bool isCheckmate() { return inCheck() && countLegalMoves() == 0; }
+    bool isStalemate() { return !inCheck() && countLegalMoves() == 0; }
     bool isDraw(int searchPly = 0) {
         return halfmove_ >= 100 || isRepetition(searchPly);
     }
+
+    // No mate is possible: bare kings, a single minor piece, or only bishops
+    // all on squares of one colour
+    bool isInsufficientMaterial() const {
+        constexpr Bitboard DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+        Bitboard heavy = pieces_[WHITE][PAWN] | pieces_[BLACK][PAWN] | pieces_[WHITE][ROOK]
+                       | pieces_[BLACK][ROOK] | pieces_[WHITE][QUEEN] | pieces_[BLACK][QUEEN];
+        if (heavy) return false;
+        Bitboard knights = pieces_[WHITE][KNIGHT] | pieces_[BLACK][KNIGHT];
+        Bitboard bishops = pieces_[WHITE][BISHOP] | pieces_[BLACK][BISHOP];
+        if (popCount(knights | bishops) <= 1) return true;
+        return !knights && (!(bishops & DARK_SQUARES) || !(bishops & ~DARK_SQUARES));
+    }
+
+    //========================================================================
+    // Integrity checks (perftDebug)
+    //========================================================================
+    // Everything makeMove maintains incrementally, recomputed from the piece
+    // bitboards. Returns what disagrees, or nullptr when the board is sound.
+    const char* verify() const {
+        // One pass over the pieces rebuilds the mailbox and the hash
+        std::uint8_t box[64];
+        std::memset(box, 0xFF, sizeof(box));
+        std::uint64_t key = Zobrist::CASTLING[castling_] ^ (sideToMove_ == BLACK ? Zobrist::SIDE : 0)
+                          ^ (epSquare_ >= 0 ? Zobrist::EP[epSquare_ & 7] : 0);
+        Bitboard all = 0;
+        for (int c = 0; c < 2; ++c) {
+            Bitboard side = 0;
+            for (int pt = PAWN; pt <= KING; ++pt) {
+                if (pieces_[c][pt] & all) return "two pieces on one square";
+                all |= pieces_[c][pt];
+                side |= pieces_[c][pt];
+                for (Bitboard bb = pieces_[c][pt]; bb; ) {
+                    int sq = popLSB(bb);
+                    box[sq] = std::uint8_t(pt | c << 3);
+                    key ^= Zobrist::PIECE[c][pt][sq];
+                }
+            }
+            if (byColor_[c] != side) return "byColor_ disagrees with pieces_";
+            if (popCount(pieces_[c][KING]) != 1 || kingSquare_[c] != lsb(pieces_[c][KING]))
+                return "kingSquare_ disagrees with pieces_";
+        }
+        if (occupied_ != all) return "occupied_ disagrees with pieces_";
+        if (std::memcmp(box, mailbox_, sizeof(box)) != 0) return "mailbox_ disagrees with pieces_";
+        if (hash_ != key) return "hash_ disagrees with the pieces and state";
+        if ((pieces_[WHITE][PAWN] | pieces_[BLACK][PAWN]) & (RANK_1 | RANK_8)) return "pawn on a back rank";
+
+        for (int idx = 0; idx < 4; ++idx) {
+            if (!(castling_ & (1 << idx))) continue;
+            Color c = Color(idx / 2);
+            if (!(pieces_[c][KING] & squareBB(Tables::CASTLING_KING_FROM[idx])) ||
+                !(pieces_[c][ROOK] & squareBB(Tables::CASTLING_ROOK_FROM[idx])))
+                return "castling right without king and rook at home";
+        }
+
+        Color us = sideToMove_, them = ~us;
+        if (epSquare_ >= 0) {
+            int pawnSq = epSquare_ + (us == WHITE ? -8 : 8);
+            if (rankOf(epSquare_) != (us == WHITE ? 5 : 2) || !isEmpty(epSquare_) ||
+                !(pieces_[them][PAWN] & squareBB(pawnSq)))
+                return "en passant square without a pawn that just double-pushed";
+        }
+
+        if (attackersTo(kingSq(them), occupied_, us)) return "side not to move is in check";
+        const CheckInfo& ci = checkInfo_;
+        int theirK = kingSq(them);
+        if (ci.checkers != attackersTo(kingSq(us), occupied_, them)) return "checkInfo_.checkers is stale";
+        if (ci.pinned != sliderBlockers(kingSq(us), us, them)) return "checkInfo_.pinned is stale";
+        if (ci.discoverers != sliderBlockers(theirK, us, us)) return "checkInfo_.discoverers is stale";
+        if (ci.checkSquares[PAWN] != Tables::PAWN_ATTACKS[them][theirK] ||
+            ci.checkSquares[KNIGHT] != Tables::KNIGHT_ATTACKS[theirK] ||
+            ci.checkSquares[BISHOP] != bishopAttacks(theirK, occupied_) ||
+            ci.checkSquares[ROOK] != rookAttacks(theirK, occupied_) ||
+            ci.checkSquares[QUEEN] != (ci.checkSquares[BISHOP] | ci.checkSquares[ROOK]) ||
+            ci.checkSquares[KING] != 0)
+            return "checkInfo_.checkSquares is stale";
+        return nullptr;
+    }
+
+    // Raw copy of every field, which unmakeMove must restore byte for byte
+    // (the stack entries it pops are only read)
+    static constexpr size_t SNAPSHOT_BYTES = 384;
+    struct Snapshot {
+        alignas(64) unsigned char bytes[SNAPSHOT_BYTES];
+    };
+
+    void takeSnapshot(Snapshot& s) const { std::memcpy(s.bytes, this, SNAPSHOT_BYTES); }
+
+    // First field that differs from the snapshot, or nullptr. Compared field
+    // by field so padding bytes never count.
+    const char* compareSnapshot(const Snapshot& s) const {
+        struct Field { size_t offset, size; const char* name; };
+#define BOARD_FIELD(f) Field{offsetof(Board, f), sizeof(Board::f), #f}
+        static constexpr Field FIELDS[] = {
+            BOARD_FIELD(pieces_), BOARD_FIELD(byColor_), BOARD_FIELD(occupied_), BOARD_FIELD(hash_),
+            BOARD_FIELD(sideToMove_), BOARD_FIELD(castling_), BOARD_FIELD(epSquare_),
+            BOARD_FIELD(halfmove_), BOARD_FIELD(kingSquare_), BOARD_FIELD(stateCount_),
+            BOARD_FIELD(checkInfo_), BOARD_FIELD(mailbox_), BOARD_FIELD(startFullmove_),
+            BOARD_FIELD(startSide_),
+        };
+#undef BOARD_FIELD
+        const unsigned char* now = reinterpret_cast<const unsigned char*>(this);
+        for (const Field& f : FIELDS)
+            if (std::memcmp(now + f.offset, s.bytes + f.offset, f.size) != 0) return f.name;
+        return nullptr;
+    }
     
     //========================================================================
     // Display
@@ -710,6 +1219,12 @@ public:
     }
 };
 
+// Copies are a single block: no history to allocate or copy
+static_assert(std::is_trivially_copyable_v<Board>, "Board must stay trivially copyable");
+static_assert(offsetof(Board, checkInfo_) + sizeof(Board::CheckInfo) <= 256 && offsetof(Board, mailbox_) == 256,
+              "hot Board fields must fill lines 0-3, mailbox on line 4");
+static_assert(sizeof(Board) == Board::SNAPSHOT_BYTES, "snapshot must cover every field");
+
 //======================================================================
 // Evaluation parameters
 //======================================================================
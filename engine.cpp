@@ -0,0 +1,29 @@
+// Engine sources, in dependency order. thisbot.cpp includes this once per
+// ISA level when building with runtime CPU dispatch.
+#include "bitboard.cpp"
+#include "move.cpp"
+#include "board.cpp"
+#include "batch.cpp"
+#include "tt.cpp"
+#include "trace.cpp"
+#include "evaluate.cpp"
+#include "search.cpp"
+#include "tune.cpp"
+#include "perfcounters.cpp"
+#include "generate.cpp"
+#if defined(MICROBENCH)
+#include "microbench.cpp"
+#endif
+#include "uci.cpp"
+
+// Entry point main() (thisbot.cpp) hands control to: the UCI loop, or the
+// primitive microbenchmarks in a -DMICROBENCH build
+int engineMain(int argc, char** argv) {
+#if defined(MICROBENCH)
+    return microbenchMain(argc, argv);
+#else
+    (void)argc;
+    (void)argv;
+    return uciMain();
+#endif
+}
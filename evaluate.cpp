@@ -163,25 +163,181 @@ struct EvalParams {
     }
 };
 
+//======================================================================
+// Evaluator
+// Static evaluation only: the parameters plus a reference to the
+// process-wide mask tables. Cheap enough for the tuners to build one
+// per call without touching the search state or the TT.
+//======================================================================
+struct EvalMasks {
+    std::array<Bitboard, 64> fileMasks{};
+    std::array<Bitboard, 64> neighborMasks{};
+    std::array<Bitboard, 64> whitePassedMasks{};
+    std::array<Bitboard, 64> blackPassedMasks{};
+    std::array<Bitboard, 64> kingZoneMasks{};
+
+    EvalMasks() {
+        for (int sq = 0; sq < 64; ++sq) {
+            int file = fileOf(sq);
+            int rank = rankOf(sq);
+
+            Bitboard fileMask = 0x0101010101010101ULL << file;
+            fileMasks[sq] = fileMask;
+
+            Bitboard adj = 0;
+            if (file > 0) adj |= 0x0101010101010101ULL << (file - 1);
+            if (file < 7) adj |= 0x0101010101010101ULL << (file + 1);
+            neighborMasks[sq] = adj;
+
+            Bitboard frontWhite = 0;
+            for (int r = rank + 1; r < 8; ++r) frontWhite |= 0xFFULL << (r * 8);
+            whitePassedMasks[sq] = (fileMask | adj) & frontWhite;
+
+            Bitboard frontBlack = 0;
+            for (int r = 0; r < rank; ++r) frontBlack |= 0xFFULL << (r * 8);
+            blackPassedMasks[sq] = (fileMask | adj) & frontBlack;
+
+            Bitboard kMask = 0;
+            for (int f = std::max(0, file - 1); f <= std::min(7, file + 1); ++f) {
+                for (int r = std::max(0, rank - 1); r <= std::min(7, rank + 2); ++r) {
+                    kMask |= 1ULL << (r * 8 + f);
+                }
+            }
+            kingZoneMasks[sq] = kMask;
+        }
+    }
+
+    // Built once per process and shared by every Evaluator
+    static const EvalMasks& get() {
+        static const EvalMasks masks;
+        return masks;
+    }
+};
+
+class Evaluator {
+public:
+    explicit Evaluator(std::shared_ptr<EvalParams> params = nullptr)
+        : params_(params ? std::move(params) : std::make_shared<EvalParams>(EvalParams::defaults())),
+          pc(EvalMasks::get()) {}
+
+    int evaluate(const Board& board) const;
+    const EvalParams& params() const { return *params_; }
+    void setParams(std::shared_ptr<EvalParams> params) { params_ = std::move(params); }
+
+private:
+    // Phase constants remain fixed (used for interpolation)
+    static constexpr int PIECE_PHASE[7]           = { 0, 1, 1, 2, 4, 0, 0 };
+
+    std::shared_ptr<EvalParams> params_;
+    const EvalMasks& pc;
+
+    int evaluateDevelopment(const Board& board, int phase) const;
+    int evaluateKingSafety(const Board& board, bool white, Bitboard friendlyPawns, Bitboard enemyPawns, int phase, int attackers, int attackUnits) const;
+};
+
+//======================================================================
+// Search statistics
+// Counters for how the search spends its nodes, bumped through
+// SEARCH_STAT(field) in search() and quiescence(). Only -DSEARCH_STATS
+// builds count; elsewhere the macro is empty and the struct is never
+// touched. Each ThisBot owns its counters, so threads never share them.
+//======================================================================
+#if defined(SEARCH_STATS)
+#define SEARCH_STAT(field) (++stats_.field)
+#else
+#define SEARCH_STAT(field) ((void)0)
+#endif
+
+// SearchTrace::push() arguments; not evaluated unless built with -DSEARCH_TRACE
+#if defined(SEARCH_TRACE)
+#define SEARCH_TRACE_EVENT(...) trace_.push(__VA_ARGS__)
+#else
+#define SEARCH_TRACE_EVENT(...) ((void)0)
+#endif
+
+struct SearchStats {
+    std::uint64_t nodes = 0, qnodes = 0;
+    std::uint64_t ttProbes = 0, ttHits = 0, ttCutoffs = 0;
+    std::uint64_t betaCutoffs = 0, firstMoveCutoffs = 0;
+    std::uint64_t nullTries = 0, nullCutoffs = 0;
+    std::uint64_t lmrSearches = 0, lmrResearches = 0;
+    std::uint64_t reverseFutility = 0, futilityPrunes = 0, moveCountPrunes = 0, seePrunes = 0;
+    std::uint64_t qDeltaPrunes = 0, qSeePrunes = 0;
+
+    SearchStats& operator+=(const SearchStats& o) {
+        nodes += o.nodes; qnodes += o.qnodes;
+        ttProbes += o.ttProbes; ttHits += o.ttHits; ttCutoffs += o.ttCutoffs;
+        betaCutoffs += o.betaCutoffs; firstMoveCutoffs += o.firstMoveCutoffs;
+        nullTries += o.nullTries; nullCutoffs += o.nullCutoffs;
+        lmrSearches += o.lmrSearches; lmrResearches += o.lmrResearches;
+        reverseFutility += o.reverseFutility; futilityPrunes += o.futilityPrunes;
+        moveCountPrunes += o.moveCountPrunes; seePrunes += o.seePrunes;
+        qDeltaPrunes += o.qDeltaPrunes; qSeePrunes += o.qSeePrunes;
+        return *this;
+    }
+
+    // Three lines: nodes and TT, cutoffs and reductions, prunes
+    void print(std::ostream& out, const char* prefix) const {
+        auto pct = [](std::uint64_t part, std::uint64_t whole) {
+            return whole ? 100.0 * double(part) / double(whole) : 0.0;
+        };
+        out << prefix << "stats nodes " << nodes << " qnodes " << qnodes
+            << " (" << pct(qnodes, nodes + qnodes) << "%)"
+            << " tt hits " << ttHits << "/" << ttProbes << " (" << pct(ttHits, ttProbes) << "%)"
+            << " tt cutoffs " << ttCutoffs << std::endl;
+        out << prefix << "stats cutoffs " << betaCutoffs
+            << " first move " << pct(firstMoveCutoffs, betaCutoffs) << "%"
+            << " nullmove " << nullCutoffs << "/" << nullTries << " (" << pct(nullCutoffs, nullTries) << "%)"
+            << " lmr researches " << lmrResearches << "/" << lmrSearches
+            << " (" << pct(lmrResearches, lmrSearches) << "%)" << std::endl;
+        out << prefix << "stats prunes reverse futility " << reverseFutility
+            << " futility " << futilityPrunes << " move count " << moveCountPrunes
+            << " see " << seePrunes << " qdelta " << qDeltaPrunes << " qsee " << qSeePrunes << std::endl;
+    }
+};
+static_assert(sizeof(SearchStats) == 17 * sizeof(std::uint64_t), "a new counter must be summed in operator+=");
+
 //======================================================================
 // ThisBot
 //======================================================================
 class ThisBot {
 public:
-    ThisBot(std::shared_ptr<EvalParams> params = nullptr);
+    ThisBot(std::shared_ptr<EvalParams> params = nullptr, size_t hashMb = 128);
     Move think(Board& board, int softMs = 200, int hardMs = 200, int maxDepth = 32, std::uint64_t maxNodes = 0);
     void stop() { stopFlag_ = true; }
     void setHashSize(size_t mbSize);
-    size_t getHashSize() const { return tt_.size() * sizeof(TTEntry) / (1024 * 1024); }
+    size_t getHashSize() const { return tt_.sizeMB(); }
+    void clearHash() { tt_.clear(); }
+    bool setSharedHash(const std::string& name) { return tt_.attachShared(name, tt_.sizeMB()); }
+    void detachSharedHash() { tt_.detachShared(); }
+    bool hashShared() const { return tt_.isShared(); }
     int getSelDepth() const { return selDepth_; }
+    std::uint64_t nodesSearched() const { return std::uint64_t(nodes_); }
+    void setQuiet(bool quiet) { quiet_ = quiet; }  // No "info" lines from think()
     int getHashFull() const;
-    void setEvalParams(std::shared_ptr<EvalParams> params) { params_ = std::move(params); }
-    const EvalParams& evalParams() const { return *params_; }
+    void setEvalParams(std::shared_ptr<EvalParams> params) { eval_.setParams(std::move(params)); }
+    const EvalParams& evalParams() const { return eval_.params(); }
+    const Evaluator& evaluator() const { return eval_; }
     int lastScore() const { return prevScore_; }
     int searchScore(Board& board, int depth, int hardMs = 0, std::uint64_t maxNodes = 0);
     int scoreMoveSearch(Board& board, Move m, int depth, int hardMs = 0, std::uint64_t maxNodes = 0);
 
-    int evaluateForTuning(Board& board) { return evaluate(board); }
+    int evaluateForTuning(const Board& board) const { return eval_.evaluate(board); }
+    int staticExchange(Board& board, Move move) { return see(board, move); }
+
+#if defined(SEARCH_STATS)
+    // Counters of the last think() and of all since clearStats()
+    const SearchStats& lastStats() const { return stats_; }
+    const SearchStats& totalStats() const { return totalStats_; }
+    void clearStats() { stats_ = totalStats_ = SearchStats(); }
+#endif
+
+#if defined(SEARCH_TRACE)
+    // Event ring of the last search; a non-empty overrun path dumps it
+    // whenever think() runs well past its hard limit
+    const SearchTrace& trace() const { return trace_; }
+    void setTraceOverrunPath(const std::string& path) { traceOverrunPath_ = path; }
+#endif
 
 private:
     using Bitboard = std::uint64_t;
@@ -189,9 +345,6 @@ private:
     static constexpr int INF = 30000;
     static constexpr int MATE = 20000;
 
-    // Phase constants remain fixed (used for interpolation)
-    static constexpr int PIECE_PHASE[7]           = { 0, 1, 1, 2, 4, 0, 0 };
-
     // Piece-square tables (0 = pawn, 1 = knight, 2 = bishop, 3 = rook, 4 = queen, 5 = king MG)
     static constexpr int PST[6][64] = {
         {
@@ -267,52 +420,10 @@ private:
         -50,-30,-30,-30,-30,-30,-30,-50
     };
 
-    struct TTEntry {
-        std::uint64_t key = 0;
-        int depth = -1;
-        int score = 0;
-        Move move{};
-        std::uint8_t flag = 0; // 1 exact, 2 lower, 3 upper
-    };
-
     struct Precomputed {
-        std::array<Bitboard, 64> fileMasks{};
-        std::array<Bitboard, 64> neighborMasks{};
-        std::array<Bitboard, 64> whitePassedMasks{};
-        std::array<Bitboard, 64> blackPassedMasks{};
-        std::array<Bitboard, 64> kingZoneMasks{};
         std::array<std::array<int, 64>, 64> lmr{};
 
         Precomputed() {
-            for (int sq = 0; sq < 64; ++sq) {
-                int file = fileOf(sq);
-                int rank = rankOf(sq);
-
-                Bitboard fileMask = 0x0101010101010101ULL << file;
-                fileMasks[sq] = fileMask;
-
-                Bitboard adj = 0;
-                if (file > 0) adj |= 0x0101010101010101ULL << (file - 1);
-                if (file < 7) adj |= 0x0101010101010101ULL << (file + 1);
-                neighborMasks[sq] = adj;
-
-                Bitboard frontWhite = 0;
-                for (int r = rank + 1; r < 8; ++r) frontWhite |= 0xFFULL << (r * 8);
-                whitePassedMasks[sq] = (fileMask | adj) & frontWhite;
-
-                Bitboard frontBlack = 0;
-                for (int r = 0; r < rank; ++r) frontBlack |= 0xFFULL << (r * 8);
-                blackPassedMasks[sq] = (fileMask | adj) & frontBlack;
-
-                Bitboard kMask = 0;
-                for (int f = std::max(0, file - 1); f <= std::min(7, file + 1); ++f) {
-                    for (int r = std::max(0, rank - 1); r <= std::min(7, rank + 2); ++r) {
-                        kMask |= 1ULL << (r * 8 + f);
-                    }
-                }
-                kingZoneMasks[sq] = kMask;
-            }
-
             for (int d = 0; d < 64; ++d) {
                 for (int m = 0; m < 64; ++m) {
                     if (d == 0 || m == 0) lmr[d][m] = 0;
@@ -322,11 +433,11 @@ private:
         }
     };
 
-    std::shared_ptr<EvalParams> params_;
+    Evaluator eval_;
     Precomputed pc;
 
     // Search state
-    std::vector<TTEntry> tt_;
+    TranspositionTable tt_;
     std::array<std::array<int, 64>, 64> history_{};
     std::array<std::array<Move, 2>, 128> killers_{};
     std::array<std::array<Move, 64>, 64> counterMoves_{};
@@ -337,6 +448,15 @@ private:
     int selDepth_ = 0;
     bool timeUp_ = false;
     volatile bool stopFlag_ = false;
+    bool quiet_ = false;
+#if defined(SEARCH_STATS)
+    SearchStats stats_;
+    SearchStats totalStats_;
+#endif
+#if defined(SEARCH_TRACE)
+    SearchTrace trace_;
+    std::string traceOverrunPath_;
+#endif
     std::chrono::steady_clock::time_point start_;
     int timeSoftMs_ = 200;
     int timeHardMs_ = 200;
@@ -361,63 +481,64 @@ private:
     }
 
     // Core routines
-    int evaluate(const Board& board);
-    int evaluateDevelopment(const Board& board, int phase);
-    int evaluateKingSafety(const Board& board, bool white, Bitboard friendlyPawns, Bitboard enemyPawns, int phase, int attackers, int attackUnits);
-    int search(Board& board, int depth, int alpha, int beta, int ply, Move prevMove);
-    int quiescence(Board& board, int alpha, int beta, int qDepth);
-    std::uint64_t hash(const Board& board) const;
+    int evaluate(const Board& board) const { return eval_.evaluate(board); }
+
+    // Every node passes through these two, so trace builds log entry and exit here
+    int search(Board& board, int depth, int alpha, int beta, int ply, Move prevMove) {
+#if defined(SEARCH_TRACE)
+        SEARCH_TRACE_EVENT(TRACE_ENTER, 0, ply, depth, alpha, beta, 0, prevMove.raw(), std::uint32_t(nodes_));
+        int score = searchNode(board, depth, alpha, beta, ply, prevMove);
+        SEARCH_TRACE_EVENT(TRACE_EXIT, traceBound(score, alpha, beta), ply, depth, alpha, beta, score, 0,
+                           std::uint32_t(nodes_));
+        return score;
+#else
+        return searchNode(board, depth, alpha, beta, ply, prevMove);
+#endif
+    }
+    int quiescence(Board& board, int alpha, int beta, int qDepth) {
+#if defined(SEARCH_TRACE)
+        SEARCH_TRACE_EVENT(TRACE_ENTER, 1, qDepth, 0, alpha, beta, 0, 0, std::uint32_t(nodes_));
+        int score = quiescenceNode(board, alpha, beta, qDepth);
+        SEARCH_TRACE_EVENT(TRACE_EXIT, traceBound(score, alpha, beta), qDepth, 0, alpha, beta, score, 0,
+                           std::uint32_t(nodes_));
+        return score;
+#else
+        return quiescenceNode(board, alpha, beta, qDepth);
+#endif
+    }
+    static int traceBound(int score, int alpha, int beta) { return score <= alpha ? 3 : score >= beta ? 2 : 1; }
+    int searchNode(Board& board, int depth, int alpha, int beta, int ply, Move prevMove);
+    int quiescenceNode(Board& board, int alpha, int beta, int qDepth);
     inline bool timeExceeded();
     inline int mvvLva(PieceType attacker, PieceType victim) const {
-        return static_cast<int>(params_->pieceValues[victim] * 10 - params_->pieceValues[attacker]);
-    }
-
-    // Zobrist
-    static inline std::array<std::array<std::array<std::uint64_t, 64>, 6>, 2> ZP{};
-    static inline std::array<std::uint64_t, 16> ZCastle{};
-    static inline std::array<std::uint64_t, 8> ZEp{};
-    static inline std::uint64_t ZSide = 0;
-    static inline std::uint64_t splitmix64(std::uint64_t& x) {
-        std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
-        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
-        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
-        return z ^ (z >> 31);
+        const auto& p = eval_.params();
+        return static_cast<int>(p.pieceValues[victim] * 10 - p.pieceValues[attacker]);
     }
-    static void initZobrist();
 
     int see(Board& board, Move move);
     int seeRecapture(Board& board, int square, PieceType lastVictim);
 };
 
-ThisBot::ThisBot(std::shared_ptr<EvalParams> params) :
-    params_(params ? std::move(params) : std::make_shared<EvalParams>(EvalParams::defaults())),
-    pc(),
-    tt_(0x800000) {
-    initZobrist();
+ThisBot::ThisBot(std::shared_ptr<EvalParams> params, size_t hashMb) :
+    eval_(std::move(params)),
+    pc() {
+    tt_.resize(hashMb);
     for (auto& row : history_) row.fill(0);
     for (auto& k : killers_) k = { Move(), Move() };
     for (auto& r : counterMoves_) for (auto& m : r) m = Move();
 }
 
 void ThisBot::setHashSize(size_t mbSize) {
-    // Calculate number of entries that fit in mbSize megabytes
-    size_t bytes = mbSize * 1024 * 1024;
-    size_t numEntries = bytes / sizeof(TTEntry);
-    // Round down to power of 2 for efficient masking
-    size_t power = 1;
-    while (power * 2 <= numEntries) power *= 2;
-    tt_.clear();
-    tt_.resize(power);
+    if (tt_.isShared()) {
+        // Re-attach: keeps the shared contents if the segment already exists
+        std::string name = tt_.sharedName();
+        if (tt_.attachShared(name, mbSize)) return;
+    }
+    tt_.resize(mbSize);
 }
 
 int ThisBot::getHashFull() const {
-    // Sample first 1000 entries to estimate hash table usage
-    int used = 0;
-    size_t sample = std::min(tt_.size(), size_t(1000));
-    for (size_t i = 0; i < sample; ++i) {
-        if (tt_[i].key != 0) ++used;
-    }
-    return static_cast<int>(used * 1000 / sample);
+    return tt_.hashFull();
 }
 
 bool ThisBot::timeExceeded() {
@@ -437,38 +558,6 @@ bool ThisBot::timeExceeded() {
     return timeUp_;
 }
 
-void ThisBot::initZobrist() {
-    static std::once_flag zobristInitFlag;
-    std::call_once(zobristInitFlag, []() {
-        std::uint64_t seed = 0x123456789abcdefULL;
-        for (int c = 0; c < 2; ++c) {
-            for (int pt = 0; pt < 6; ++pt) {
-                for (int sq = 0; sq < 64; ++sq) {
-                    ZP[c][pt][sq] = splitmix64(seed);
-                }
-            }
-        }
-        for (int i = 0; i < 16; ++i) ZCastle[i] = splitmix64(seed);
-        for (int i = 0; i < 8; ++i) ZEp[i] = splitmix64(seed);
-        ZSide = splitmix64(seed);
-    });
-}
-
-std::uint64_t ThisBot::hash(const Board& board) const {
-    std::uint64_t h = 0;
-    for (int sq = 0; sq < 64; ++sq) {
-        if (board.mailbox_[sq] != 0xFF) {
-            int pt = board.mailbox_[sq] & 7;
-            int c = (board.mailbox_[sq] >> 3) & 1;
-            h ^= ZP[c][pt][sq];
-        }
-    }
-    h ^= ZCastle[board.castling_];
-    if (board.epSquare_ >= 0) h ^= ZEp[board.epSquare_ & 7];
-    if (board.sideToMove_ == BLACK) h ^= ZSide;
-    return h;
-}
-
 int ThisBot::seeRecapture(Board& board, int square, PieceType lastVictim) {
     int minValue = INF;
     Move best;
@@ -478,7 +567,7 @@ int ThisBot::seeRecapture(Board& board, int square, PieceType lastVictim) {
     for (Move m : moves) {
         if (m.to() != square) continue;
         PieceType attacker = board.pieceAt(m.from());
-        int v = static_cast<int>(params_->pieceValues[attacker]);
+        int v = static_cast<int>(eval_.params().pieceValues[attacker]);
         if (v < minValue) {
             minValue = v;
             best = m;
@@ -487,11 +576,11 @@ int ThisBot::seeRecapture(Board& board, int square, PieceType lastVictim) {
 
     if (best.isNull()) return 0;
 
-    auto undo = board.makeMove(best);
+    board.makeMove(best);
     PieceType nextVictim = board.pieceAt(best.to());
-    int value = static_cast<int>(params_->pieceValues[lastVictim]);
+    int value = static_cast<int>(eval_.params().pieceValues[lastVictim]);
     int next = seeRecapture(board, square, nextVictim);
-    board.unmakeMove(best, undo);
+    board.unmakeMove(best);
 
     return std::max(0, value - next);
 }
@@ -501,23 +590,23 @@ int ThisBot::see(Board& board, Move move) {
     if (!isCapture) return 0;
 
     PieceType captured = move.type() == MT_EN_PASSANT ? PAWN : board.pieceAt(move.to());
-    int value = static_cast<int>(params_->pieceValues[captured]);
+    int value = static_cast<int>(eval_.params().pieceValues[captured]);
 
     PieceType mover = board.pieceAt(move.from());
     if (move.type() == MT_PROMOTION) {
-        value += static_cast<int>(params_->pieceValues[move.promo()] - 100);
+        value += static_cast<int>(eval_.params().pieceValues[move.promo()] - 100);
     }
 
-    auto undo = board.makeMove(move);
+    board.makeMove(move);
     PieceType nextVictim = move.type() == MT_PROMOTION ? move.promo() : mover;
     int recapture = seeRecapture(board, move.to(), nextVictim);
-    board.unmakeMove(move, undo);
+    board.unmakeMove(move);
 
     return value - recapture;
 }
 
 
-int ThisBot::evaluateDevelopment(const Board& board, int phase) {
+int Evaluator::evaluateDevelopment(const Board& board, int phase) const {
     if (phase < 16) return 0;
 
     const auto& p = *params_;
@@ -552,7 +641,7 @@ int ThisBot::evaluateDevelopment(const Board& board, int phase) {
     return score;
 }
 
-int ThisBot::evaluateKingSafety(const Board& board, bool white, Bitboard friendlyPawns, Bitboard enemyPawns, int phase, int attackers, int attackUnits) {
+int Evaluator::evaluateKingSafety(const Board& board, bool white, Bitboard friendlyPawns, Bitboard enemyPawns, int phase, int attackers, int attackUnits) const {
     if (phase < 10 || attackers == 0) return 0;
     attackers = std::min(attackers, 8);
 
@@ -583,7 +672,7 @@ int ThisBot::evaluateKingSafety(const Board& board, bool white, Bitboard friendl
     return safety;
 }
 
-int ThisBot::evaluate(const Board& board) {
+int Evaluator::evaluate(const Board& board) const {
     int mgScore = 0, egScore = 0, phase = 0;
     int whiteBishops = 0, blackBishops = 0;
     bool whiteLightBishop = false, whiteDarkBishop = false;
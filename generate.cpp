@@ -1,99 +1,707 @@
 std::uint64_t perft(chess::Board& board, int depth) {
     if (depth == 0) return 1;
+    if (depth == 1) return board.countLegalMoves();
 
     chess::MoveList moves;
     board.generateLegalMoves(moves);
 
-    if (depth == 1)
-        return moves.size();
-
     std::uint64_t nodes = 0;
+
+    // Children are leaves: count their moves BATCH_LANES positions at a time
+    if (depth == 2) {
+        chess::BoardBatch batch;
+        for (auto m : moves) {
+            board.makeMove(m);
+            batch.push(board);
+            board.unmakeMove(m);
+            if (batch.full()) {
+                nodes += batch.totalLegalMoves();
+                batch.clear();
+            }
+        }
+        if (batch.size()) nodes += batch.totalLegalMoves();
+        return nodes;
+    }
+
     for (auto m : moves) {
-        auto undo = board.makeMove(m);
+        board.makeMove(m);
         nodes += perft(board, depth - 1);
-        board.unmakeMove(m, undo);
+        board.unmakeMove(m);
     }
     return nodes;
 }
 
-std::uint64_t perftDebug(chess::Board& board, int depth, int maxDepth) {
-    using namespace chess;
+//============================================================================
+// Make/unmake integrity walk: Board::verify() after every makeMove, and the
+// raw board state compared with a snapshot after every unmakeMove. The first
+// fault stops the process with the move path that led to it.
+//============================================================================
+[[noreturn]] static void perftDebugFail(const chess::Board& board, const std::vector<chess::Move>& path,
+                                        const char* when, const char* what) {
+    static std::mutex failMutex;
+    std::lock_guard<std::mutex> lock(failMutex);  // Other threads may be failing too
+    std::cerr << "\nSTATE CORRUPTION " << when << ": " << what << "\n";
+    std::cerr << "Path:";
+    for (auto m : path) std::cerr << " " << board.moveToUCI(m);
+    std::cerr << "\nFEN: " << board.toFEN() << std::endl;
+    std::_Exit(1);  // Other workers are still running: no static destructors under them
+}
 
-    // Snapshot current position
-    std::string fenBefore = board.toFEN();
+static std::uint64_t perftDebugWalk(chess::Board& board, int depth, std::vector<chess::Move>& path) {
+    using namespace chess;
+    Board::Snapshot before;
+    board.takeSnapshot(before);
 
     MoveList moves;
     board.generateLegalMoves(moves);
 
-    if (depth == 0) {
-        // Should never be reached from the top; kept for completeness
-        return 1;
+    std::uint64_t nodes = 0;
+    for (Move m : moves) {
+        path.push_back(m);
+        board.makeMove(m);
+        if (const char* fault = board.verify()) perftDebugFail(board, path, "after makeMove", fault);
+
+        nodes += depth > 1 ? perftDebugWalk(board, depth - 1, path) : 1;
+
+        board.unmakeMove(m);
+        if (const char* field = board.compareSnapshot(before))
+            perftDebugFail(board, path, "after unmakeMove, field differs", field);
+        path.pop_back();
     }
+    return nodes;
+}
+
+// Root moves are shared out to threads, each walking on its own board copy
+std::uint64_t perftDebug(chess::Board& board, int depth, int threads = 1) {
+    using namespace chess;
+    std::vector<Move> rootPath;
+    if (const char* fault = board.verify()) perftDebugFail(board, rootPath, "at the root", fault);
+    if (depth <= 0) return 1;
 
-    if (depth == 1) {
-        std::uint64_t nodes = 0;
+    MoveList rootMoves;
+    board.generateLegalMoves(rootMoves);
+    std::atomic<int> next{0};
+    std::atomic<std::uint64_t> total{0};
+    auto worker = [&]() {
+        Board::StateStack states;
+        Board local = board;
+        local.useStates(states);  // Its own history, off the caller's stack
+        Board::Snapshot before;
+        local.takeSnapshot(before);
+        std::vector<Move> path;
+        for (int i; (i = next.fetch_add(1, std::memory_order_relaxed)) < rootMoves.size(); ) {
+            Move m = rootMoves[i];
+            path.assign(1, m);
+            local.makeMove(m);
+            if (const char* fault = local.verify()) perftDebugFail(local, path, "after makeMove", fault);
+            total += depth > 1 ? perftDebugWalk(local, depth - 1, path) : 1;
+            local.unmakeMove(m);
+            if (const char* field = local.compareSnapshot(before))
+                perftDebugFail(local, path, "after unmakeMove, field differs", field);
+        }
+    };
 
-        for (Move m : moves) {
-            auto undo = board.makeMove(m);
+    std::vector<std::thread> pool;
+    for (int k = 1; k < threads; ++k) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    return total;
+}
 
-            board.unmakeMove(m, undo);
+//============================================================================
+// Parallel perft with a shared perft hash
+//============================================================================
+// Lock-free: each entry stores its data and key ^ data, so an entry torn by a
+// concurrent store fails the key check and reads as a miss
+class PerftHash {
+    struct Entry {
+        std::atomic<std::uint64_t> check;  // key ^ data
+        std::atomic<std::uint64_t> data;   // nodes << 8 | depth
+    };
+    std::unique_ptr<Entry[]> entries_;
+    std::uint64_t mask_ = 0;
 
-            std::string fenAfter = board.toFEN();
-            if (fenAfter != fenBefore) {
-                std::cerr << "\nSTATE CORRUPTION at depth 1\n";
-                std::cerr << "Move: " << board.moveToUCI(m) << "\n";
-                std::cerr << "Before: " << fenBefore << "\n";
-                std::cerr << "After:  " << fenAfter << "\n";
-                std::exit(1);
-            }
+public:
+    explicit PerftHash(int mb) {
+        size_t n = 1;
+        while (n * 2 * sizeof(Entry) <= (size_t(mb) << 20)) n *= 2;
+        entries_.reset(new Entry[n]());
+        mask_ = n - 1;
+    }
 
-            ++nodes;
-        }
+    bool probe(std::uint64_t key, int depth, std::uint64_t& nodes) const {
+        const Entry& e = entries_[key & mask_];
+        std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        std::uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || int(data & 0xFF) != depth) return false;
+        nodes = data >> 8;
+        return true;
+    }
 
-        return nodes;
+    void store(std::uint64_t key, int depth, std::uint64_t nodes) {
+        Entry& e = entries_[key & mask_];
+        std::uint64_t data = nodes << 8 | std::uint64_t(depth);
+        e.data.store(data, std::memory_order_relaxed);
+        e.check.store(key ^ data, std::memory_order_relaxed);
     }
+};
+
+static std::uint64_t perftHashed(chess::Board& board, int depth, PerftHash* hash) {
+    // A depth-1 count is cheaper than a probe
+    if (!hash || depth < 2) return perft(board, depth);
 
     std::uint64_t nodes = 0;
+    if (hash->probe(board.hash_, depth, nodes)) return nodes;
 
-    for (Move m : moves) {
-        auto undo = board.makeMove(m);
+    chess::MoveList moves;
+    board.generateLegalMoves(moves);
+    for (auto m : moves) {
+        board.makeMove(m);
+        nodes += perftHashed(board, depth - 1, hash);
+        board.unmakeMove(m);
+    }
+    hash->store(board.hash_, depth, nodes);
+    return nodes;
+}
+
+// Subtrees are queued as root move + reply pairs (root moves alone when
+// shallow) and handed out through one atomic index, so a thread that finishes
+// early takes the next pair instead of idling behind a big root move.
+// perRoot, if given, receives the node count of each legal root move in
+// generation order.
+std::uint64_t perftParallel(chess::Board& board, int depth, int threads, int hashMb,
+                            std::vector<std::uint64_t>* perRoot = nullptr) {
+    using namespace chess;
+    MoveList rootMoves;
+    board.generateLegalMoves(rootMoves);
+    if (perRoot) perRoot->assign(rootMoves.size(), 1);
+    if (depth <= 1) return depth == 0 ? 1 : rootMoves.size();
 
-        nodes += perftDebug(board, depth - 1, maxDepth);
+    struct Task { int root; Move reply; };
+    std::vector<Task> tasks;
+    bool split = threads > 1 && depth >= 4;
+    for (int i = 0; i < rootMoves.size(); ++i) {
+        if (!split) { tasks.push_back({i, Move()}); continue; }
+        MoveList replies;
+        board.makeMove(rootMoves[i]);
+        board.generateLegalMoves(replies);
+        board.unmakeMove(rootMoves[i]);
+        for (Move r : replies) tasks.push_back({i, r});
+    }
 
-        board.unmakeMove(m, undo);
+    std::unique_ptr<PerftHash> hash;
+    if (hashMb > 0) hash = std::make_unique<PerftHash>(hashMb);
 
-        std::string fenAfter = board.toFEN();
-        if (fenAfter != fenBefore) {
-            std::cerr << "\nSTATE CORRUPTION detected\n";
-            std::cerr << "At recursive depth: " << (maxDepth - depth + 1) << "\n";
-            std::cerr << "After unmaking move: " << board.moveToUCI(m) << "\n";
-            std::cerr << "Expected FEN: " << fenBefore << "\n";
-            std::cerr << "Got FEN:      " << fenAfter << "\n";
-            std::exit(1);
+    std::vector<std::atomic<std::uint64_t>> counts(rootMoves.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        Board::StateStack states;
+        Board local = board;
+        local.useStates(states);  // Its own history, off the caller's stack
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < tasks.size(); ) {
+            const Task& t = tasks[i];
+            Move root = rootMoves[t.root];
+            std::uint64_t nodes;
+            local.makeMove(root);
+            if (t.reply.isNull()) {
+                nodes = perftHashed(local, depth - 1, hash.get());
+            } else {
+                local.makeMove(t.reply);
+                nodes = perftHashed(local, depth - 2, hash.get());
+                local.unmakeMove(t.reply);
+            }
+            local.unmakeMove(root);
+            counts[t.root].fetch_add(nodes, std::memory_order_relaxed);
         }
-    }
+    };
 
-    return nodes;
+    std::vector<std::thread> pool;
+    for (int k = 1; k < threads; ++k) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    std::uint64_t total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        std::uint64_t n = counts[i].load();
+        if (perRoot) (*perRoot)[i] = n;
+        total += n;
+    }
+    return total;
 }
 
-void perftDivide(chess::Board& board, int depth) {
+std::uint64_t perftDivide(chess::Board& board, int depth, int threads = 1, int hashMb = 0) {
     chess::MoveList moves;
     board.generateLegalMoves(moves);
 
-    std::uint64_t total = 0;
-
-    for (auto m : moves) {
-        auto undo = board.makeMove(m);
-        std::uint64_t nodes = perft(board, depth - 1);
-        board.unmakeMove(m, undo);
+    std::vector<std::uint64_t> perRoot;
+    std::uint64_t total = perftParallel(board, depth, threads, hashMb, &perRoot);
 
-        std::cout << board.moveToUCI(m) << ": " << nodes << "\n";
-        total += nodes;
-    }
+    for (int i = 0; i < moves.size(); ++i)
+        std::cout << board.moveToUCI(moves[i]) << ": " << perRoot[i] << "\n";
 
     std::cout << "Total: " << total << "\n";
+    return total;
 }
 
 //-----------------------------------------------------------------------------
 // UCI loop - Complete implementation for GUI compatibility (CuteChess, Arena, etc.)
 //-----------------------------------------------------------------------------
+
+//============================================================================
+// Slider backend microbenchmark: occupancies harvested from perft trees of
+// the standard test positions, replayed through every compiled-in backend
+//============================================================================
+struct SliderQuery {
+    chess::Bitboard occ;
+    std::uint8_t sq;
+    bool rook;
+};
+
+static void collectSliderQueries(chess::Board& board, int depth, std::vector<SliderQuery>& out) {
+    using namespace chess;
+    for (int c = 0; c < 2; ++c) {
+        Bitboard rq = board.pieces_[c][ROOK] | board.pieces_[c][QUEEN];
+        Bitboard bq = board.pieces_[c][BISHOP] | board.pieces_[c][QUEEN];
+        while (rq) out.push_back({board.occupied_, std::uint8_t(popLSB(rq)), true});
+        while (bq) out.push_back({board.occupied_, std::uint8_t(popLSB(bq)), false});
+    }
+    if (depth == 0) return;
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (auto m : moves) {
+        board.makeMove(m);
+        collectSliderQueries(board, depth - 1, out);
+        board.unmakeMove(m);
+    }
+}
+
+template<typename Backend>
+static void runSliderBackend(const std::vector<SliderQuery>& queries, int reps) {
+    using namespace chess;
+    // Correctness first: every backend must agree with the magic tables
+    for (const auto& q : queries) {
+        Bitboard want = q.rook ? Sliders::Magic::rook(q.sq, q.occ) : Sliders::Magic::bishop(q.sq, q.occ);
+        Bitboard got = q.rook ? Backend::rook(q.sq, q.occ) : Backend::bishop(q.sq, q.occ);
+        if (want != got) {
+            std::cout << Backend::NAME << ": MISMATCH on square " << int(q.sq) << std::endl;
+            return;
+        }
+    }
+
+    // Each lookup feeds the next one's occupancy, so this measures latency as
+    // in move generation, and the checksum must match across backends
+    Bitboard checksum = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+        for (const auto& q : queries) {
+            Bitboard occ = q.occ ^ (checksum & 1);
+            checksum += q.rook ? Backend::rook(q.sq, occ) : Backend::bishop(q.sq, occ);
+        }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << Backend::NAME << ": " << ns / (double(queries.size()) * reps) << " ns/lookup"
+              << (std::is_same_v<Backend, Sliders::Active> ? "  (active)" : "")
+              << "  [" << std::hex << checksum << std::dec << "]" << std::endl;
+}
+
+// The standard perft test positions
+static const char* const PERFT_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+void sliderBench(int reps) {
+    using namespace chess;
+    std::vector<SliderQuery> queries;
+    Board::StateStack states;
+    Board board(states);
+    for (const char* fen : PERFT_FENS) {
+        board.setFEN(fen);
+        collectSliderQueries(board, 2, queries);
+    }
+    std::cout << "Slider lookups: " << queries.size() << " x " << reps << std::endl;
+
+    runSliderBackend<Sliders::Magic>(queries, reps);
+#if defined(__BMI2__) || defined(ENGINE_TARGET_BMI2)
+    runSliderBackend<Sliders::Pext>(queries, reps);
+#endif
+    runSliderBackend<Sliders::Kindergarten>(queries, reps);
+    runSliderBackend<Sliders::KoggeStone>(queries, reps);
+}
+
+//============================================================================
+// FEN parse/serialize benchmark over every position of depth-3 perft trees
+//============================================================================
+static void collectFENs(chess::Board& board, int depth, std::string& text, std::vector<size_t>& ends) {
+    using namespace chess;
+    char buf[FEN_BUFFER_SIZE];
+    text.append(buf, board.writeFEN(buf));
+    ends.push_back(text.size());
+    if (depth == 0) return;
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (auto m : moves) {
+        board.makeMove(m);
+        collectFENs(board, depth - 1, text, ends);
+        board.unmakeMove(m);
+    }
+}
+
+void fenBench(int reps) {
+    using namespace chess;
+    std::string text;
+    std::vector<size_t> ends;
+    Board::StateStack states;
+    Board board(states);
+    for (const char* fen : PERFT_FENS) {
+        board.setFEN(fen);
+        collectFENs(board, 3, text, ends);
+    }
+    std::vector<std::string_view> fens;
+    for (size_t i = 0, begin = 0; i < ends.size(); begin = ends[i++])
+        fens.emplace_back(text.data() + begin, ends[i] - begin);
+
+    // Round trip must reproduce every string exactly
+    char buf[FEN_BUFFER_SIZE];
+    for (std::string_view fen : fens) {
+        FenError err = board.parseFEN(fen);
+        int len = board.writeFEN(buf);
+        if (err != FenError::None || std::string_view(buf, len) != fen) {
+            std::cout << "FEN round trip FAILED (" << fenErrorString(err) << "): " << fen << std::endl;
+            return;
+        }
+    }
+    std::cout << "FEN positions: " << fens.size() << " x " << reps << std::endl;
+
+    // Timed with and without writeFEN; the difference is the write cost
+    auto run = [&](bool write) {
+        std::uint64_t checksum = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            for (std::string_view fen : fens) {
+                board.parseFEN(fen);
+                checksum += board.hash_;
+                if (write) checksum += board.writeFEN(buf) + std::uint8_t(buf[0]);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "  [" << std::hex << checksum << std::dec << "]" << std::endl;
+        return ns / (double(fens.size()) * reps);
+    };
+    std::cout << "parse:";
+    double parseNs = run(false);
+    std::cout << "parse+write:";
+    double bothNs = run(true);
+    double writeNs = std::max(0.0, bothNs - parseNs);
+    std::cout << "parseFEN: " << parseNs << " ns (" << 1e3 / parseNs << " M/s)" << std::endl;
+    std::cout << "writeFEN: " << writeNs << " ns (" << (writeNs > 0 ? 1e3 / writeNs : 0.0) << " M/s)" << std::endl;
+}
+
+//============================================================================
+// Board throughput: make/unmake replayed from recorded walks, and perft, over
+// the standard test positions. Run on builds of two layouts to compare them.
+//============================================================================
+// Depth-3 walk as a move script; a null Move means "unmake the last move",
+// so replaying it measures make/unmake without move generation
+static void recordWalk(chess::Board& board, int depth, std::vector<chess::Move>& script) {
+    using namespace chess;
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (auto m : moves) {
+        script.push_back(m);
+        if (depth > 1) {
+            board.makeMove(m);
+            recordWalk(board, depth - 1, script);
+            board.unmakeMove(m);
+        }
+        script.push_back(Move());
+    }
+}
+
+void boardBench(int reps) {
+    using namespace chess;
+    std::cout << "Board: " << sizeof(Board) << " bytes, align " << alignof(Board)
+              << ", mailbox at +" << offsetof(Board, mailbox_)
+              << ", state stack " << sizeof(Board::StateStack) << " bytes (the caller's)" << std::endl;
+
+    std::vector<std::vector<Move>> scripts;
+    Board::StateStack states;
+    Board board(states);
+    std::uint64_t pairs = 0;
+    for (const char* fen : PERFT_FENS) {
+        board.setFEN(fen);
+        scripts.emplace_back();
+        recordWalk(board, 3, scripts.back());
+        pairs += scripts.back().size() / 2;
+    }
+    std::cout << "make/unmake pairs: " << pairs << " x " << reps << std::endl;
+
+    std::uint64_t checksum = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < scripts.size(); ++i) {
+            board.setFEN(PERFT_FENS[i]);
+            Move made[4];
+            int n = 0;
+            for (Move m : scripts[i]) {
+                if (m.isNull()) {
+                    board.unmakeMove(made[--n]);
+                } else {
+                    board.makeMove(made[n++] = m);
+                    checksum += board.hash_;
+                }
+            }
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+    double perPair = ns / (double(pairs) * reps);
+    std::cout << "make+unmake: " << perPair << " ns (" << 1e3 / perPair << " M/s)"
+              << "  [" << std::hex << checksum << std::dec << "]" << std::endl;
+
+    std::uint64_t nodes = 0;
+    startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (const char* fen : PERFT_FENS) {
+            board.setFEN(fen);
+            nodes += perft(board, 4);
+        }
+    }
+    ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "perft 4: " << nodes / reps << " nodes, " << nodes * 1e3 / ns << " M nodes/s" << std::endl;
+}
+
+//============================================================================
+// Perft suite: EPD lines "<fen> ;D1 20 ;D2 400 ...", every annotated depth up
+// to maxDepth checked, positions spread over threads. The movegen gate.
+//============================================================================
+struct PerftSuiteEntry {
+    int line;
+    std::string fen;
+    std::vector<std::pair<int, std::uint64_t>> expected;  // (depth, nodes)
+    std::vector<std::uint64_t> got;
+};
+
+void perftSuite(const std::string& path, int maxDepth, int threads) {
+    using namespace chess;
+    std::ifstream in(path);
+    if (!in) {
+        std::cout << "perftsuite: cannot open " << path << std::endl;
+        return;
+    }
+
+    std::vector<PerftSuiteEntry> entries;
+    int failed = 0;
+    std::string text;
+    for (int lineNo = 1; std::getline(in, text); ++lineNo) {
+        size_t semi = text.find(';');
+        std::string fen = text.substr(0, semi);
+        size_t end = fen.find_last_not_of(" \t\r");
+        if (end == std::string::npos || text[0] == '#') continue;
+
+        PerftSuiteEntry e{lineNo, fen.substr(0, end + 1), {}, {}};
+        Board board;
+        FenError err = board.parseFEN(e.fen);
+        if (err != FenError::None) {
+            std::cout << "line " << lineNo << ": invalid fen (" << fenErrorString(err) << "): " << e.fen << std::endl;
+            ++failed;
+            continue;
+        }
+        for (size_t p = semi; p != std::string::npos; p = text.find(';', p + 1)) {
+            std::istringstream field(text.substr(p + 1, text.find(';', p + 1) - p - 1));
+            std::string tag;
+            std::uint64_t nodes;
+            if (field >> tag >> nodes && tag.size() > 1 && tag[0] == 'D') {
+                int depth = std::atoi(tag.c_str() + 1);
+                if (depth >= 1 && depth <= maxDepth) e.expected.push_back({depth, nodes});
+            }
+        }
+        e.got.assign(e.expected.size(), 0);
+        if (!e.expected.empty()) entries.push_back(std::move(e));
+    }
+
+    // One job per (position, depth), deepest first so the long ones start early
+    std::vector<std::pair<int, int>> jobs;
+    for (int i = 0; i < int(entries.size()); ++i)
+        for (int k = 0; k < int(entries[i].expected.size()); ++k) jobs.push_back({i, k});
+    std::stable_sort(jobs.begin(), jobs.end(), [&](const auto& a, const auto& b) {
+        return entries[a.first].expected[a.second].first > entries[b.first].expected[b.second].first;
+    });
+
+    std::atomic<size_t> next{0};
+    PerfCounters counters;
+    auto startTime = std::chrono::steady_clock::now();
+    counters.start();
+    auto worker = [&]() {
+        Board::StateStack states;
+        Board board(states);
+        for (size_t j; (j = next.fetch_add(1, std::memory_order_relaxed)) < jobs.size(); ) {
+            PerftSuiteEntry& e = entries[jobs[j].first];
+            board.setFEN(e.fen);
+            e.got[jobs[j].second] = perft(board, e.expected[jobs[j].second].first);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int k = 1; k < threads; ++k) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    counters.stop();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    std::uint64_t total = 0;
+    for (const auto& e : entries) {
+        for (size_t k = 0; k < e.expected.size(); ++k) {
+            total += e.got[k];
+            if (e.got[k] == e.expected[k].second) continue;
+            ++failed;
+            std::cout << "line " << e.line << " D" << e.expected[k].first << ": expected "
+                      << e.expected[k].second << ", got " << e.got[k] << ": " << e.fen << std::endl;
+        }
+    }
+    auto nps = elapsed > 0 ? (total * 1000ULL) / elapsed : 0;
+    std::cout << "Positions: " << entries.size() << ", counts checked: " << jobs.size()
+              << ", failed: " << failed << std::endl;
+    std::cout << "Nodes: " << total << std::endl;
+    std::cout << "Time: " << elapsed << " ms" << std::endl;
+    std::cout << "NPS: " << nps << std::endl;
+    counters.report(std::cout, "", double(total), "node");
+}
+
+//============================================================================
+// Search bench: fixed-depth searches of a built-in position set (or a file of
+// FENs). Each position gets a fresh searcher, so the total node count is a
+// signature of the search itself: a change that should not alter the search
+// must leave it unchanged.
+//============================================================================
+static const char* const BENCH_FENS[] = {
+    // Openings and middlegames
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+    "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+    "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+    "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+    "3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "5rk1/q6p/2p3bR/1pPp1rP1/1P1Pp3/P3B1Q1/1K3P2/R7 w - - 93 90",
+    "4rrk1/1p1nq3/p7/2p1P1pp/3P2bp/3Q1Bn1/PPPB4/1K2R1NR w - - 40 21",
+    "r3k2r/3nnpbp/q2pp1p1/p7/Pp1PPPP1/4BNN1/1P5P/R2Q1RK1 w kq - 0 16",
+    "3Qb1k1/1r2ppb1/pN1n2q1/Pp1Pp1Pr/4P2p/4BP2/4B1R1/1R5K b - - 11 40",
+    "4k3/3q1r2/1N2r1b1/3ppN2/2nPP3/1B1R2n1/2R1Q3/3K4 w - - 5 1",
+    // Tactical
+    "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - 0 1",
+    "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+    "r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+    "1r3k2/4q3/2Pp3b/3Bp3/2Q2p2/1p1P2P1/1P2KP2/3N4 w - - 0 1",
+    "8/7p/5k2/5p2/p1p2P2/Pr1pPK2/1P1R3P/8 b - - 0 1",
+    // Endgames
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+    "3b4/5kp1/1p1p1p1p/pP1PpP1P/P1P1P3/3KN3/8/8 w - - 0 1",
+    "2K5/p7/7P/5pR1/8/5k2/r7/8 w - - 0 1",
+    "8/6pk/1p6/8/PP3p1p/5P2/4KP1q/3Q4 w - - 0 1",
+    "7k/3p2pp/4q3/8/4Q3/5Kp1/P6b/8 w - - 0 1",
+    "8/2p5/8/2kPKp1p/2p4P/2P5/3P4/8 w - - 0 1",
+    "8/1p3pp1/7p/5P1P/2k3P1/8/2K2P2/8 w - - 0 1",
+    "8/pp2r1k1/2p1p3/3pP2p/1P1P1P1P/P5KR/8/8 w - - 0 1",
+    "8/3p4/p1bk3p/Pp6/1Kp1PpPp/2P2P1P/2P5/5B2 b - - 0 1",
+    "5k2/7R/4P2p/5K2/p1r2P1p/8/8/8 b - - 0 1",
+    "6k1/6p1/P6p/r1N5/5p2/7P/1b3PP1/4R1K1 w - - 0 1",
+    "6k1/4pp1p/3p2p1/P1pPb3/R7/1r2P1PP/3B1P2/6K1 w - - 0 1",
+    "8/3p3B/5p2/5P2/p7/PP5b/k7/6K1 w - - 0 1",
+    "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+    "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+    // Mate and stalemate on the board
+    "8/8/8/8/8/6k1/6p1/6K1 w - - 0 1",
+    "7k/7P/6K1/8/3B4/8/8/8 b - - 0 1",
+};
+
+// maxNodes > 0 stops each position's search at that many nodes instead of at depth
+void searchBench(int depth, std::uint64_t maxNodes, int hashMb, int threads, const std::string& file) {
+    using namespace chess;
+    std::vector<std::string> fens;
+    if (file.empty()) {
+        fens.assign(std::begin(BENCH_FENS), std::end(BENCH_FENS));
+    } else {
+        std::ifstream in(file);
+        if (!in) {
+            std::cout << "bench: cannot open " << file << std::endl;
+            return;
+        }
+        for (std::string text; std::getline(in, text); ) {
+            std::string fen = text.substr(0, text.find(';'));
+            size_t end = fen.find_last_not_of(" \t\r");
+            if (end != std::string::npos && text[0] != '#') fens.push_back(fen.substr(0, end + 1));
+        }
+    }
+    for (const auto& fen : fens) {
+        Board board;
+        FenError err = board.parseFEN(fen);
+        if (err != FenError::None) {
+            std::cout << "bench: invalid fen (" << fenErrorString(err) << "): " << fen << std::endl;
+            return;
+        }
+    }
+
+    // Positions are independent, so threads take whole positions
+    std::vector<std::uint64_t> nodes(fens.size());
+    std::vector<Move> best(fens.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        Board::StateStack states;
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < fens.size(); ) {
+            Board board(states);
+            board.setFEN(fens[i]);
+            auto bot = std::make_unique<ThisBot>(nullptr, size_t(hashMb));
+            bot->setQuiet(true);
+            best[i] = bot->think(board, 0, 0, depth, maxNodes);
+            nodes[i] = bot->nodesSearched();
+        }
+    };
+    PerfCounters counters;
+    auto startTime = std::chrono::steady_clock::now();
+    counters.start();
+    std::vector<std::thread> pool;
+    for (int k = 1; k < threads; ++k) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    counters.stop();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    std::uint64_t total = 0;
+    for (size_t i = 0; i < fens.size(); ++i) {
+        Board board;
+        board.setFEN(fens[i]);
+        std::cout << "Position " << i + 1 << "/" << fens.size() << ": " << nodes[i] << " nodes, "
+                  << (best[i].isNull() ? "(none)" : board.moveToUCI(best[i])) << "  " << fens[i] << std::endl;
+        total += nodes[i];
+    }
+    auto nps = elapsed > 0 ? (total * 1000ULL) / elapsed : 0;
+    std::cout << "===========================" << std::endl;
+    std::cout << "Total time (ms) : " << elapsed << std::endl;
+    std::cout << "Nodes searched  : " << total << std::endl;
+    std::cout << "Nodes/second    : " << nps << std::endl;
+    counters.report(std::cout, "", double(total), "node");
+}
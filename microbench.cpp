@@ -0,0 +1,278 @@
+//============================================================================
+// Microbenchmarks of engine primitives
+// Built as its own binary with -DMICROBENCH (see README). Every primitive
+// runs over the same fixed corpus: the bench positions and their children.
+// A sample is one timed pass (repeated to at least 2 ms); after a warm-up
+// pass the median and median absolute deviation of the samples are reported
+// in ns/op. The checksum proves two runs did the same work, so a diff of two
+// --json files is meaningful only where the checksums agree.
+//============================================================================
+struct MicroResult {
+    std::string name;
+    std::uint64_t ops = 0;          // Operations per pass
+    double opsTimed = 0;            // Operations over all samples
+    std::uint64_t checksum = 0;
+    std::vector<double> samples;    // ns/op
+    double median = 0, mad = 0, min = 0;
+    double events[chess::PerfCounters::EVENT_COUNT];  // Per op over all samples, -1 = n/a
+};
+
+struct MicroCorpus {
+    std::vector<std::string> fens;
+    std::vector<chess::Board> boards;
+    std::vector<chess::Move> moves;         // Legal moves of every board, back to back
+    std::vector<std::uint32_t> moveStart;   // boards[i]'s moves: [moveStart[i], moveStart[i+1])
+    std::vector<std::uint64_t> keys;        // Hash of every board and every child
+    chess::Board::StateStack states;        // Shared by the boards: each move is unmade at once
+};
+
+static void buildMicroCorpus(MicroCorpus& c, size_t count) {
+    using namespace chess;
+    std::vector<std::string> all;
+    Board board(c.states);
+    for (const char* fen : BENCH_FENS) {
+        board.setFEN(fen);
+        all.push_back(board.toFEN());
+        MoveList moves;
+        board.generateLegalMoves(moves);
+        for (auto m : moves) {
+            board.makeMove(m);
+            all.push_back(board.toFEN());
+            board.unmakeMove(m);
+        }
+    }
+    // Evenly spaced so every bench position contributes
+    count = std::min(count, all.size());
+    for (size_t i = 0; i < count; ++i) c.fens.push_back(all[i * all.size() / count]);
+
+    c.boards.assign(count, Board(c.states));
+    c.moveStart.push_back(0);
+    for (size_t i = 0; i < count; ++i) {
+        Board& b = c.boards[i];
+        b.setFEN(c.fens[i]);
+        c.keys.push_back(b.hash_);
+        MoveList moves;
+        b.generateLegalMoves(moves);
+        for (auto m : moves) {
+            c.moves.push_back(m);
+            b.makeMove(m);
+            c.keys.push_back(b.hash_);
+            b.unmakeMove(m);
+        }
+        c.moveStart.push_back(std::uint32_t(c.moves.size()));
+    }
+}
+
+static double microMedian(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// pass() runs the primitive once over the corpus and returns a checksum
+template<typename Pass>
+static MicroResult runMicro(const std::string& name, std::uint64_t ops, int reps,
+                            chess::PerfCounters& counters, Pass&& pass) {
+    using clock = std::chrono::steady_clock;
+    MicroResult r;
+    r.name = name;
+    r.ops = ops;
+
+    // Warm-up, which also sizes a sample to at least 2 ms
+    auto t0 = clock::now();
+    r.checksum = pass();
+    double warmNs = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+    int inner = int(std::clamp(2e6 / std::max(warmNs, 1.0), 1.0, 1e6));
+
+    counters.start();
+    for (int s = 0; s < reps; ++s) {
+        std::uint64_t sum = 0;
+        t0 = clock::now();
+        for (int k = 0; k < inner; ++k) sum += pass();
+        double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        if (sum != r.checksum * std::uint64_t(inner)) r.checksum = ~0ULL;  // Not repeatable
+        r.samples.push_back(ns / (double(ops) * inner));
+    }
+    counters.stop();
+    r.opsTimed = double(ops) * inner * reps;
+    for (int e = 0; e < chess::PerfCounters::EVENT_COUNT; ++e) {
+        double v = counters.value(chess::PerfCounters::Event(e));
+        r.events[e] = v < 0 ? -1 : v / r.opsTimed;
+    }
+
+    r.median = microMedian(r.samples);
+    std::vector<double> dev;
+    for (double x : r.samples) dev.push_back(std::fabs(x - r.median));
+    r.mad = microMedian(dev);
+    r.min = *std::min_element(r.samples.begin(), r.samples.end());
+    return r;
+}
+
+static void writeMicroJson(std::ostream& out, const MicroCorpus& c, int reps, const std::vector<MicroResult>& results) {
+    out << "{\n  \"isa\": \"" << ENGINE_ISA_NAME << "\",\n"
+        << "  \"positions\": " << c.boards.size() << ",\n"
+        << "  \"reps\": " << reps << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const MicroResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ops\": " << r.ops
+            << ", \"median_ns\": " << r.median << ", \"mad_ns\": " << r.mad << ", \"min_ns\": " << r.min
+            << ", \"checksum\": \"" << std::hex << r.checksum << std::dec << "\"";
+        if (chess::PerfCounters::enabled) {
+            // Hardware events per op; null where unavailable
+            for (int e = 0; e < chess::PerfCounters::EVENT_COUNT; ++e) {
+                out << ", \"" << chess::PerfCounters::name(chess::PerfCounters::Event(e)) << "\": ";
+                if (r.events[e] < 0) out << "null";
+                else out << r.events[e];
+            }
+        }
+        out << ", \"samples\": [";
+        for (size_t k = 0; k < r.samples.size(); ++k) out << (k ? ", " : "") << r.samples[k];
+        out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// thisbot-microbench [--reps <n>] [--positions <n>] [--filter <substring>] [--json <file>] [--counters]
+int microbenchMain(int argc, char** argv) {
+    using namespace chess;
+    int reps = 15;
+    size_t positions = 512;
+    std::string filter, jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--reps" && hasValue) reps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--positions" && hasValue) positions = size_t(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--counters") PerfCounters::enabled = true;
+        else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--reps <n>] [--positions <n>] [--filter <substring>] [--json <file>] [--counters]" << std::endl;
+            return 2;
+        }
+    }
+
+    MicroCorpus c;
+    buildMicroCorpus(c, positions);
+    const size_t n = c.boards.size();
+    std::cout << "microbench: " << n << " positions, " << c.moves.size() << " moves, "
+              << reps << " samples, isa " << ENGINE_ISA_NAME << std::endl;
+
+    std::vector<Move> captures;
+    std::vector<std::uint32_t> captureBoard;
+    for (size_t i = 0; i < n; ++i)
+        for (std::uint32_t k = c.moveStart[i]; k < c.moveStart[i + 1]; ++k) {
+            Move m = c.moves[k];
+            if (!c.boards[i].isEmpty(m.to()) || m.type() == MT_EN_PASSANT) {
+                captures.push_back(m);
+                captureBoard.push_back(std::uint32_t(i));
+            }
+        }
+
+    ThisBot bot(nullptr, 1);
+    Evaluator evaluator;
+    TranspositionTable tt;
+    tt.resize(16);
+    Board scratch;
+    char fenBuf[128];
+    PerfCounters counters;
+    if (PerfCounters::enabled && !counters.available()) counters.report(std::cout, "", 1, "op");
+
+    std::vector<MicroResult> results;
+    auto run = [&](const std::string& name, std::uint64_t ops, auto&& pass) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        results.push_back(runMicro(name, ops, reps, counters, pass));
+        const MicroResult& r = results.back();
+        std::cout << r.name << ": " << r.median << " ns/op, mad " << r.mad
+                  << " (" << (r.median > 0 ? 100.0 * r.mad / r.median : 0.0) << "%), min " << r.min
+                  << "  [" << std::hex << r.checksum << std::dec << "]" << std::endl;
+        if (counters.available()) counters.report(std::cout, "  ", r.opsTimed, "op");
+    };
+
+    run("movegen", n, [&] {
+        std::uint64_t sum = 0;
+        MoveList moves;
+        for (auto& b : c.boards) {
+            b.generateLegalMoves(moves);
+            sum += moves.size();
+        }
+        return sum;
+    });
+    run("movecount", n, [&] {
+        std::uint64_t sum = 0;
+        for (auto& b : c.boards) sum += b.countLegalMoves();
+        return sum;
+    });
+    run("make_unmake", c.moves.size(), [&] {
+        std::uint64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            Board& b = c.boards[i];
+            for (std::uint32_t k = c.moveStart[i]; k < c.moveStart[i + 1]; ++k) {
+                b.makeMove(c.moves[k]);
+                sum += b.hash_;
+                b.unmakeMove(c.moves[k]);
+            }
+        }
+        return sum;
+    });
+    run("evaluate", n, [&] {
+        std::uint64_t sum = 0;
+        for (const auto& b : c.boards) sum += std::uint64_t(evaluator.evaluate(b));
+        return sum;
+    });
+    run("see", captures.size(), [&] {
+        std::uint64_t sum = 0;
+        for (size_t k = 0; k < captures.size(); ++k)
+            sum += std::uint64_t(bot.staticExchange(c.boards[captureBoard[k]], captures[k]));
+        return sum;
+    });
+    run("slider_rook", n * 64, [&] {
+        std::uint64_t sum = 0;
+        for (const auto& b : c.boards)
+            for (int sq = 0; sq < 64; ++sq) sum += rookAttacks(sq, b.occupied_);
+        return sum;
+    });
+    run("slider_bishop", n * 64, [&] {
+        std::uint64_t sum = 0;
+        for (const auto& b : c.boards)
+            for (int sq = 0; sq < 64; ++sq) sum += bishopAttacks(sq, b.occupied_);
+        return sum;
+    });
+    run("fen_parse", n, [&] {
+        std::uint64_t sum = 0;
+        for (const auto& fen : c.fens) {
+            scratch.parseFEN(fen);
+            sum += scratch.hash_;
+        }
+        return sum;
+    });
+    run("fen_write", n, [&] {
+        std::uint64_t sum = 0;
+        for (const auto& b : c.boards) sum += std::uint64_t(b.writeFEN(fenBuf));
+        return sum;
+    });
+    run("tt_store", c.keys.size(), [&] {
+        int d = 0;
+        for (std::uint64_t key : c.keys) tt.store(key, ++d & 15, 0, Move(), 1);
+        return std::uint64_t(d);
+    });
+    run("tt_probe", c.keys.size(), [&] {
+        std::uint64_t sum = 0;
+        TTData data;
+        for (std::uint64_t key : c.keys) sum += tt.probe(key, data) ? std::uint64_t(data.depth) : 0;
+        return sum;
+    });
+
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        if (!out) {
+            std::cerr << "microbench: cannot write " << jsonPath << std::endl;
+            return 1;
+        }
+        writeMicroJson(out, c, reps, results);
+        std::cout << "wrote " << jsonPath << std::endl;
+    }
+    return 0;
+}
@@ -4,11 +4,11 @@ enum MoveType : std::uint8_t {
 };
 
 class Move {
-    std::uint32_t data_;
+    std::uint16_t data_;
 public:
     constexpr Move() : data_(0) {}
     constexpr Move(int from, int to, MoveType mt = MT_NORMAL, PieceType promo = KNIGHT)
-        : data_(from | (to << 6) | (mt << 12) | ((promo - KNIGHT) << 14)) {}
+        : data_(std::uint16_t(from | (to << 6) | (mt << 12) | ((promo - KNIGHT) << 14))) {}
     
     FORCE_INLINE int from() const { return data_ & 0x3F; }
     FORCE_INLINE int to() const { return (data_ >> 6) & 0x3F; }
@@ -16,8 +16,10 @@ public:
     FORCE_INLINE PieceType promo() const { return PieceType(((data_ >> 14) & 0x3) + KNIGHT); }
     FORCE_INLINE bool isNull() const { return data_ == 0; }
     FORCE_INLINE bool operator==(Move other) const { return data_ == other.data_; }
-    FORCE_INLINE std::uint32_t raw() const { return data_; }
+    FORCE_INLINE std::uint16_t raw() const { return data_; }
+    static constexpr Move fromRaw(std::uint16_t raw) { Move m; m.data_ = raw; return m; }
 };
+static_assert(sizeof(Move) == 2, "Move must stay 16 bits");
 
 //============================================================================
 // OPTIMIZATION 6: Fixed-size move list (no heap allocation)
@@ -38,6 +40,67 @@ public:
     FORCE_INLINE const Move* end() const { return moves_.data() + size_; }
 };
 
+// Stand-in for MoveList when only the number of moves matters: the
+// generators add whole target sets with one popcount instead of writing moves
+class MoveCounter {
+    int count_ = 0;
+public:
+    FORCE_INLINE void push(Move) { ++count_; }
+    FORCE_INLINE void add(int n) { count_ += n; }
+    FORCE_INLINE void clear() { count_ = 0; }
+    FORCE_INLINE int size() const { return count_; }
+};
+
+//============================================================================
+// Scored move list for ordering
+// A move sorts together with its score in one 8-byte entry, and carries the
+// moving and captured piece, read once from the mailbox when it is scored,
+// so the search loop does not look them up again.
+//============================================================================
+struct ExtMove {
+    Move move;
+    PieceType moving;
+    PieceType captured;  // NO_PIECE unless a capture; PAWN for en passant
+    int score;
+
+    FORCE_INLINE bool isCapture() const { return captured != NO_PIECE; }
+};
+static_assert(sizeof(ExtMove) == 8, "ExtMove should pack into 8 bytes");
+
+class ExtMoveList {
+    std::array<ExtMove, 256> moves_;
+    int size_ = 0;
+public:
+    FORCE_INLINE ExtMove& push(Move m, PieceType moving, PieceType captured, int score = 0) {
+        ExtMove& e = moves_[size_++];
+        e = {m, moving, captured, score};
+        return e;
+    }
+    FORCE_INLINE void clear() { size_ = 0; }
+    FORCE_INLINE int size() const { return size_; }
+    FORCE_INLINE bool empty() const { return size_ == 0; }
+    FORCE_INLINE const ExtMove& operator[](int i) const { return moves_[i]; }
+    FORCE_INLINE ExtMove& operator[](int i) { return moves_[i]; }
+    FORCE_INLINE ExtMove* begin() { return moves_.data(); }
+    FORCE_INLINE ExtMove* end() { return moves_.data() + size_; }
+    FORCE_INLINE const ExtMove* begin() const { return moves_.data(); }
+    FORCE_INLINE const ExtMove* end() const { return moves_.data() + size_; }
+
+    // Stable insertion sort, highest score first; lists are short and mostly
+    // small, where this beats std::stable_sort
+    void sortDescending() {
+        for (int i = 1; i < size_; ++i) {
+            ExtMove e = moves_[i];
+            int j = i - 1;
+            while (j >= 0 && moves_[j].score < e.score) {
+                moves_[j + 1] = moves_[j];
+                --j;
+            }
+            moves_[j + 1] = e;
+        }
+    }
+};
+
 //============================================================================
 // OPTIMIZATION 7: Precomputed attack tables with better layout
 //============================================================================
@@ -65,9 +128,8 @@ inline PieceType charToPT(char c) {
 }
 
 inline char ptToChar(PieceType pt, Color c) {
-    static constexpr char ch[] = "PNBRQK?";
-    char r = ch[pt];
-    return c == BLACK ? std::tolower(r) : r;
+    static constexpr char ch[2][8] = { "PNBRQK?", "pnbrqk?" };
+    return ch[c][pt];
 }
 
 //============================================================================
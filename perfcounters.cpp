@@ -0,0 +1,136 @@
+namespace chess {
+
+//============================================================================
+// Hardware performance counters (Linux perf_event_open)
+// Optional counts of cycles, instructions, branch misses and L1d/LLC/dTLB
+// misses around bench, perft and the microbenchmarks, user space only so an
+// unprivileged process may open them (perf_event_paranoid <= 2). Counters are
+// inherited by threads spawned while they run, so multi-threaded phases are
+// counted whole once their threads are joined. Where the kernel, container or
+// CPU refuses an event it is left out; with none at all the benches print
+// their usual time-only output plus one "unavailable" line.
+//============================================================================
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, BRANCH_MISSES, L1D_MISSES, LLC_MISSES, DTLB_MISSES, EVENT_COUNT };
+
+    // Off by default; "perfcounters on" (UCI) or --counters (microbench)
+    static inline bool enabled = false;
+
+    PerfCounters() {
+        for (auto& fd : fd_) fd = -1;
+        for (auto& v : value_) v = -1;
+        if (enabled) open();
+    }
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        for (int fd : fd_) if (fd >= 0) return true;
+        return false;
+    }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fd_) {
+            if (fd < 0) continue;
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            if (fd_[i] < 0) continue;
+            ::ioctl(fd_[i], PERF_EVENT_IOC_DISABLE, 0);
+            // value, time enabled, time running: scale up if multiplexed
+            std::uint64_t r[3] = {};
+            if (::read(fd_[i], r, sizeof(r)) != ssize_t(sizeof(r)) || r[2] == 0) value_[i] = -1;
+            else value_[i] = double(r[0]) * (double(r[1]) / double(r[2]));
+        }
+#endif
+    }
+
+    // Count from the last start()/stop(), or -1 when the event is unavailable
+    double value(Event e) const { return value_[e]; }
+
+    static const char* name(Event e) {
+        static const char* const NAMES[EVENT_COUNT] = {
+            "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses", "dTLB-misses"
+        };
+        return NAMES[e];
+    }
+
+    // "<prefix>counters: IPC 2.31, per node: 1141 cycles, ..." - nothing when
+    // counters are off, one "unavailable" line when they could not be opened
+    void report(std::ostream& out, const char* prefix, double ops, const char* opName) const {
+        if (!enabled) return;
+        out << prefix << "counters: ";
+        if (!available()) {
+            out << "unavailable (";
+            if (error_) out << "perf_event_open: " << std::strerror(error_);
+            else out << "not supported on this platform";
+            out << ")" << std::endl;
+            return;
+        }
+        if (value_[CYCLES] > 0 && value_[INSTRUCTIONS] >= 0)
+            out << "IPC " << value_[INSTRUCTIONS] / value_[CYCLES] << ", ";
+        out << "per " << opName << ":";
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            out << (i ? ", " : " ");
+            if (value_[i] < 0) out << "n/a";
+            else out << value_[i] / std::max(ops, 1.0);
+            out << " " << name(Event(i));
+        }
+        out << std::endl;
+    }
+
+private:
+    int fd_[EVENT_COUNT];
+    double value_[EVENT_COUNT];
+    int error_ = 0;  // errno of the first failed open, 0 = no perf_event_open
+
+    void open() {
+#if defined(__linux__)
+        auto cache = [](std::uint64_t id) {
+            return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        const std::pair<std::uint32_t, std::uint64_t> events[EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB)},
+        };
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd_[i] = int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd_[i] < 0 && i == 0) error_ = errno;
+        }
+#endif
+    }
+
+    void close() {
+#if defined(__linux__)
+        for (int& fd : fd_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+#endif
+    }
+};
+
+} // namespace chess
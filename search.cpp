@@ -24,6 +24,13 @@ Move ThisBot::think(Board& board, int softMs, int hardMs, int maxDepth, std::uin
     selDepth_ = 0;
     start_ = std::chrono::steady_clock::now();
     bestRoot_ = Move();
+#if defined(SEARCH_STATS)
+    stats_ = SearchStats();
+#endif
+#if defined(SEARCH_TRACE)
+    trace_.reserve();
+    trace_.clear();
+#endif
 
     MoveList rootMoves;
     board.generateLegalMoves(rootMoves);
@@ -41,11 +48,19 @@ Move ThisBot::think(Board& board, int softMs, int hardMs, int maxDepth, std::uin
 
         int alpha = -INF, beta = INF;
         if (depth >= 5) { alpha = prevScore_ - 50; beta = prevScore_ + 50; }
-        int score = search(board, depth, alpha, beta, 0, Move());
-        if (!timeUp_ && (score <= alpha || score >= beta)) {
-            alpha = -INF; beta = INF;
+        int score;
+        SEARCH_TRACE_EVENT(TRACE_ITER_START, 0, 0, depth, alpha, beta, 0, 0, std::uint32_t(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count()));
+        {
+            NoAllocScope hotPath(depth > 1);  // Iteration 1 is the warm-up
             score = search(board, depth, alpha, beta, 0, Move());
+            if (!timeUp_ && (score <= alpha || score >= beta)) {
+                alpha = -INF; beta = INF;
+                score = search(board, depth, alpha, beta, 0, Move());
+            }
         }
+        SEARCH_TRACE_EVENT(TRACE_ITER_END, timeUp_ ? 1 : 0, 0, depth, alpha, beta, score, 0, std::uint32_t(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count()));
         if (timeUp_) break;
         prevRoot_ = bestRoot_;
         prevScore_ = score;
@@ -65,89 +80,103 @@ Move ThisBot::think(Board& board, int softMs, int hardMs, int maxDepth, std::uin
             scoreStr = "cp " + std::to_string(score);
         }
         
-        std::cout << "info depth " << depth
-                  << " seldepth " << selDepth_
-                  << " score " << scoreStr
-                  << " time " << elapsed
-                  << " nodes " << nodes_
-                  << " nps " << nps
-                  << " hashfull " << getHashFull()
-                  << " pv " << board.moveToUCI(bestRoot_)
-                  << std::endl;
+        if (!quiet_) {
+            std::cout << "info depth " << depth
+                      << " seldepth " << selDepth_
+                      << " score " << scoreStr
+                      << " time " << elapsed
+                      << " nodes " << nodes_
+                      << " nps " << nps
+                      << " hashfull " << getHashFull()
+                      << " pv " << board.moveToUCI(bestRoot_)
+                      << std::endl;
+        }
 
         if (timeSoftMs_ > 0 && elapsed >= timeSoftMs_) break;
         
         if (std::abs(score) > 19000) break;
     }
 
+#if defined(SEARCH_STATS)
+    totalStats_ += stats_;
+    if (!quiet_) stats_.print(std::cout, "info string ");
+#endif
+#if defined(SEARCH_TRACE)
+    auto spentMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+    if (!traceOverrunPath_.empty() && timeHardMs_ > 0 && spentMs > timeHardMs_ + std::max(5, timeHardMs_ / 10)) {
+        bool dumped = trace_.dump(traceOverrunPath_);
+        std::cout << "info string trace: " << spentMs << " ms against a " << timeHardMs_ << " ms limit, "
+                  << (dumped ? "dumped to " : "cannot write ") << traceOverrunPath_ << std::endl;
+    }
+#endif
+
     Move result = timeUp_ ? prevRoot_ : bestRoot_;
     if (result.isNull()) result = rootMoves[0];
     return result;
 }
 
 
-int ThisBot::quiescence(Board& board, int alpha, int beta, int qDepth) {
+int ThisBot::quiescenceNode(Board& board, int alpha, int beta, int qDepth) {
+    SEARCH_STAT(qnodes);
     if (stopFlag_) { timeUp_ = true; return 0; }
     if (timeUp_ || qDepth > 10) return evaluate(board);
 
-    const auto& p = *params_;
+    const auto& p = eval_.params();
     bool lowMaterial = isLowMaterialEnding(board);
     int standPat = evaluate(board);
     if (standPat >= beta) return beta;
     if (alpha < standPat) alpha = standPat;
 
     MoveList moves;
-    board.generateLegalMoves(moves);
+    board.generatePseudoLegalMoves(moves);
 
-    std::vector<std::pair<int, Move>> scoredMoves;
-    for (int i = 0; i < moves.size(); ++i) {
-        Move m = moves[i];
-        bool isCapture = !board.isEmpty(m.to()) || m.type() == MT_EN_PASSANT;
+    ExtMoveList scoredMoves;
+    for (Move m : moves) {
+        PieceType captured = board.capturedPiece(m);
         bool isPromo = m.type() == MT_PROMOTION;
-        if (!isCapture && !isPromo) continue;
+        if (captured == NO_PIECE && !isPromo) continue;
 
+        PieceType moving = board.pieceAt(m.from());
         int score = 0;
-        if (isCapture) {
-            PieceType captured = m.type() == MT_EN_PASSANT ? PAWN : board.pieceAt(m.to());
-            score = static_cast<int>(p.pieceValues[captured] * 10 - p.pieceValues[board.pieceAt(m.from())]);
-        }
+        if (captured != NO_PIECE)
+            score = static_cast<int>(p.pieceValues[captured] * 10 - p.pieceValues[moving]);
         if (isPromo) score += 8000;
-        scoredMoves.push_back({score, m});
+        scoredMoves.push(m, moving, captured, score);
     }
 
     if (scoredMoves.empty()) return alpha;
+    scoredMoves.sortDescending();
 
-    for (size_t i = 1; i < scoredMoves.size(); ++i) {
-        auto temp = scoredMoves[i];
-        int j = static_cast<int>(i) - 1;
-        while (j >= 0 && scoredMoves[j].first < temp.first) {
-            scoredMoves[j + 1] = scoredMoves[j];
-            --j;
-        }
-        scoredMoves[j + 1] = temp;
-    }
+    Bitboard pinned = board.pinnedPieces();
+
+    for (const ExtMove& e : scoredMoves) {
+        Move m = e.move;
+        if (!board.isLegal(m, pinned)) continue;
 
-    for (const auto& [moveScore, m] : scoredMoves) {
-        bool isCapture = !board.isEmpty(m.to()) || m.type() == MT_EN_PASSANT;
         bool isPromo = m.type() == MT_PROMOTION;
 
         if (!isPromo) {
-            PieceType captured = m.type() == MT_EN_PASSANT ? PAWN : board.pieceAt(m.to());
-            int margin = (captured == PAWN || lowMaterial) ? 0 : 200;
-            if (standPat + static_cast<int>(p.pieceValues[captured]) + margin < alpha) continue;
-        }
+            int margin = (e.captured == PAWN || lowMaterial) ? 0 : 200;
+            if (standPat + static_cast<int>(p.pieceValues[e.captured]) + margin < alpha) {
+                SEARCH_STAT(qDeltaPrunes);
+                SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_QDELTA, qDepth, 0, alpha, beta, standPat, m.raw(),
+                                   std::uint32_t(nodes_));
+                continue;
+            }
 
-        if (!isPromo && isCapture) {
-            int attacker = static_cast<int>(p.pieceValues[board.pieceAt(m.from())]);
-            PieceType captured = m.type() == MT_EN_PASSANT ? PAWN : board.pieceAt(m.to());
-            int victim = static_cast<int>(p.pieceValues[captured]);
-            if (attacker - victim > 80 && attacker > victim && see(board, m) < 0)
+            int attacker = static_cast<int>(p.pieceValues[e.moving]);
+            int victim = static_cast<int>(p.pieceValues[e.captured]);
+            if (attacker - victim > 80 && attacker > victim && see(board, m) < 0) {
+                SEARCH_STAT(qSeePrunes);
+                SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_QSEE, qDepth, 0, alpha, beta, standPat, m.raw(),
+                                   std::uint32_t(nodes_));
                 continue;
+            }
         }
 
-        auto undo = board.makeMove(m);
+        board.makeMove(m);
         int score = -quiescence(board, -beta, -alpha, qDepth + 1);
-        board.unmakeMove(m, undo);
+        board.unmakeMove(m);
 
         if (timeUp_) return 0;
 
@@ -157,8 +186,9 @@ int ThisBot::quiescence(Board& board, int alpha, int beta, int qDepth) {
     return alpha;
 }
 
-int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move prevMove) {
+int ThisBot::searchNode(Board& board, int depth, int alpha, int beta, int ply, Move prevMove) {
     if (ply >= 100) return evaluate(board);
+    SEARCH_STAT(nodes);
     
     if (ply > selDepth_) selDepth_ = ply;
 
@@ -182,7 +212,7 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
     bool isRoot = ply == 0;
     bool pvNode = (beta - alpha) > 1;
     int origAlpha = alpha;
-    const auto& p = *params_;
+    const auto& p = eval_.params();
 
     if (board.isDraw(ply)) return 0;
 
@@ -192,51 +222,62 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
 
     if (depth <= 0) return quiescence(board, alpha, beta, 0);
 
-    std::uint64_t key = hash(board);
-    TTEntry& tt = tt_[key & (tt_.size() - 1)];
+    std::uint64_t key = board.hash_;  // Same Zobrist keys, maintained incrementally
+    TTData tt;
     Move ttMove;
     
     // TT lookup - restrict cutoffs at PV nodes
-    if (tt.key == key) {
+    SEARCH_STAT(ttProbes);
+    if (tt_.probe(key, tt)) {
+        SEARCH_STAT(ttHits);
+        SEARCH_TRACE_EVENT(TRACE_TT_HIT, tt.flag, ply, tt.depth, alpha, beta, tt.score, tt.move.raw(),
+                           std::uint32_t(nodes_));
         ttMove = tt.move;
         if (!isRoot && tt.depth >= depth) {
             int ttScore = scoreFromTT(tt.score, ply);
-            if (tt.flag == 1) {
-                // Exact score - can use at PV nodes
+            // Exact scores can be used at PV nodes, bounds only at non-PV nodes
+            if (tt.flag == 1 ||
+                (!pvNode && ((tt.flag == 2 && ttScore >= beta) || (tt.flag == 3 && ttScore <= alpha)))) {
+                SEARCH_STAT(ttCutoffs);
                 return ttScore;
             }
-            if (!pvNode) {
-                // Bounds only usable at non-PV nodes
-                if (tt.flag == 2 && ttScore >= beta) return ttScore;
-                if (tt.flag == 3 && ttScore <= alpha) return ttScore;
-            }
         }
     }
 
     int staticEval = inCheck ? -MATE : evaluate(board);
     bool lateEg = isLowMaterialEnding(board);
 
-    if (!pvNode && !inCheck && depth <= 6 && staticEval - 90 * depth >= beta)
+    if (!pvNode && !inCheck && depth <= 6 && staticEval - 90 * depth >= beta) {
+        SEARCH_STAT(reverseFutility);
+        SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_REVERSE_FUTILITY, ply, depth, alpha, beta, staticEval, 0,
+                           std::uint32_t(nodes_));
         return staticEval;
+    }
 
     // Null-move pruning
     if (!inCheck && !pvNode && depth >= 3 && staticEval >= beta && hasNonPawnMaterial(board)) {
-        auto nu = board.makeNullMove();
+        SEARCH_STAT(nullTries);
+        board.makeNullMove();
         int R = 3 + depth / 4;
         int score = -search(board, depth - R, -beta, -beta + 1, ply + 1, Move());
-        board.unmakeNullMove(nu);
+        board.unmakeNullMove();
         if (timeUp_) return 0;
-        if (score >= beta) return score;
+        if (score >= beta) {
+            SEARCH_STAT(nullCutoffs);
+            SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_NULL_MOVE, ply, depth, alpha, beta, score, 0, std::uint32_t(nodes_));
+            return score;
+        }
     }
 
     // PV TT warmup
     if (depth >= 6 && pvNode && ttMove.isNull()) {
         search(board, depth - 3, alpha, beta, ply, prevMove);
-        if (tt.key == key) ttMove = tt.move;
+        if (tt_.probe(key, tt)) ttMove = tt.move;
     }
 
+    // Pseudo-legal list: legality is checked lazily, only for moves we reach
     MoveList moves;
-    board.generateLegalMoves(moves);
+    board.generatePseudoLegalMoves(moves);
     int moveCount = moves.size();
     if (moveCount == 0) {
         if (!inCheck) return 0;
@@ -244,7 +285,7 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
         return mateScore;
     }
 
-    // Validate ttMove is in the legal move list
+    // Validate ttMove is in the move list (legality is checked when it is searched)
     bool ttMoveValid = false;
     if (!ttMove.isNull()) {
         for (int i = 0; i < moveCount; ++i) {
@@ -256,112 +297,74 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
         if (!ttMoveValid) ttMove = Move();
     }
 
-    if (moveCount == 1) {
-        Move m = moves[0];
-        bool isQuiet = board.isEmpty(m.to()) && m.type() != MT_PROMOTION && m.type() != MT_EN_PASSANT;
-
-        auto u = board.makeMove(m);
-        int score = -search(board, depth - 1, -beta, -alpha, ply + 1, m);
-        board.unmakeMove(m, u);
-        if (timeUp_) return 0;
-
-        int bestScore = score;
-        Move bestMove = m;
-
-        if (score > alpha) {
-            alpha = score;
-            if (isRoot) bestRoot_ = m;
-            if (score >= beta && isQuiet) {
-                history_[m.from()][m.to()] += depth * depth;
-                if (ply < 128 && !(m == killers_[ply][0])) {
-                    killers_[ply][1] = killers_[ply][0];
-                    killers_[ply][0] = m;
-                }
-                if (!prevMove.isNull()) {
-                    counterMoves_[prevMove.from()][prevMove.to()] = m;
-                }
-            }
-        }
-        
-        if (tt.key != key || depth >= tt.depth) {
-            tt.key = key; 
-            tt.depth = depth; 
-            tt.score = scoreToTT(bestScore, ply);
-            tt.move = bestMove;
-            tt.flag = bestScore <= origAlpha ? 3 : bestScore >= beta ? 2 : 1;
-        }
-        return bestScore;
-    }
-
-    std::vector<int> scores(moveCount, 0);
-    for (int i = 0; i < moveCount; ++i) {
-        Move m = moves[i];
-        if (m == ttMove) { scores[i] = 2000000; continue; }
-
-        bool isCapture = !board.isEmpty(m.to()) || m.type() == MT_EN_PASSANT;
-        PieceType moving = board.pieceAt(m.from());
-        PieceType captured = isCapture ? (m.type() == MT_EN_PASSANT ? PAWN : board.pieceAt(m.to())) : NO_PIECE;
-
-        if (isCapture) {
-            scores[i] = 1000000 + mvvLva(moving, captured);
+    ExtMoveList ordered;
+    for (Move m : moves) {
+        ExtMove& e = ordered.push(m, board.pieceAt(m.from()), board.capturedPiece(m));
+        if (m == ttMove) {
+            e.score = 2000000;
+        } else if (e.isCapture()) {
+            e.score = 1000000 + mvvLva(e.moving, e.captured);
         } else if (m.type() == MT_PROMOTION) {
-            scores[i] = 900000 + static_cast<int>(p.pieceValues[m.promo()]);
+            e.score = 900000 + static_cast<int>(p.pieceValues[m.promo()]);
         } else if (ply < 128 && m == killers_[ply][0]) {
-            scores[i] = 800000;
+            e.score = 800000;
         } else if (!prevMove.isNull() && m == counterMoves_[prevMove.from()][prevMove.to()]) {
-            scores[i] = 750000;
+            e.score = 750000;
         } else if (ply < 128 && m == killers_[ply][1]) {
-            scores[i] = 700000;
+            e.score = 700000;
         } else {
-            scores[i] = history_[m.from()][m.to()];
+            e.score = history_[m.from()][m.to()];
         }
     }
-
-    for (int i = 1; i < moveCount; ++i) {
-        int s = scores[i];
-        Move m = moves[i];
-        int j = i - 1;
-        while (j >= 0 && scores[j] < s) {
-            scores[j + 1] = scores[j];
-            moves[j + 1] = moves[j];
-            --j;
-        }
-        scores[j + 1] = s;
-        moves[j + 1] = m;
-    }
+    ordered.sortDescending();
 
     int bestScore = -INF;
-    Move bestMove = moves[0];
+    Move bestMove;
     int movesSearched = 0;
+    Bitboard pinned = board.pinnedPieces();
 
     int lmrIdx = std::min(depth, 63);
     const auto& lmrRow = pc.lmr[lmrIdx];
 
-    // Track quiet moves tried for history penalty
-    std::vector<Move> quietsTried;
+    // Track quiet moves tried for history penalty (on the stack: no allocation per node)
+    MoveList quietsTried;
+
+    for (const ExtMove& e : ordered) {
+        Move m = e.move;
+        if (!board.isLegal(m, pinned)) continue;
 
-    for (int i = 0; i < moveCount; ++i) {
-        Move m = moves[i];
-        bool isCapture = !board.isEmpty(m.to()) || m.type() == MT_EN_PASSANT;
         bool isPromotion = m.type() == MT_PROMOTION;
-        bool isQuiet = !isCapture && !isPromotion;
+        bool isQuiet = !e.isCapture() && !isPromotion;
 
         // SEE-based capture pruning
-        if (m.type() != MT_EN_PASSANT && !board.isEmpty(m.to()) && movesSearched > 0 && !isPromotion) {
-            PieceType attacker = board.pieceAt(m.from());
-            PieceType victim = board.pieceAt(m.to());
-            if (p.pieceValues[attacker] - p.pieceValues[victim] > 80 && depth <= 6 && movesSearched >= 2) {
+        if (m.type() != MT_EN_PASSANT && e.isCapture() && movesSearched > 0 && !isPromotion) {
+            if (p.pieceValues[e.moving] - p.pieceValues[e.captured] > 80 && depth <= 6 && movesSearched >= 2) {
                 int s = see(board, m);
-                if (s < -100) continue;
+                if (s < -100) {
+                    SEARCH_STAT(seePrunes);
+                    SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_SEE, ply, depth, alpha, beta, s, m.raw(), std::uint32_t(nodes_));
+                    continue;
+                }
             }
         }
 
         // Quiet pruning
-        if (!lateEg && !pvNode && !inCheck && depth <= 7 && staticEval + 100 * depth < alpha && movesSearched > 0 && isQuiet && bestScore > -19000) continue;
-        if (!lateEg && !pvNode && !inCheck && depth <= 5 && movesSearched >= 4 + depth * depth / 2 && isQuiet && bestScore > -19000) continue;
+        if (!lateEg && !pvNode && !inCheck && depth <= 7 && staticEval + 100 * depth < alpha && movesSearched > 0 && isQuiet && bestScore > -19000) {
+            SEARCH_STAT(futilityPrunes);
+            SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_FUTILITY, ply, depth, alpha, beta, staticEval, m.raw(),
+                               std::uint32_t(nodes_));
+            continue;
+        }
+        if (!lateEg && !pvNode && !inCheck && depth <= 5 && movesSearched >= 4 + depth * depth / 2 && isQuiet && bestScore > -19000) {
+            SEARCH_STAT(moveCountPrunes);
+            SEARCH_TRACE_EVENT(TRACE_PRUNE, PRUNE_MOVE_COUNT, ply, depth, alpha, beta, staticEval, m.raw(),
+                               std::uint32_t(nodes_));
+            continue;
+        }
 
-        auto undo = board.makeMove(m);
-        bool givesCheck = board.inCheck();
+        // Decided from the cached check info, before paying for makeMove
+        bool givesCheck = board.givesCheck(m);
+        board.makeMove(m);
         int score;
 
         if (movesSearched >= 3 && depth >= 3 && isQuiet && !inCheck && !givesCheck) {
@@ -369,8 +372,12 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
             reduction = std::min(reduction, depth - 2);
             if (pvNode) reduction = std::max(0, reduction - 1);
             if (lateEg) reduction = std::max(0, reduction - 1);
+            SEARCH_STAT(lmrSearches);
             score = -search(board, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, m);
-            if (score > alpha) score = -search(board, depth - 1, -beta, -alpha, ply + 1, m);
+            if (score > alpha) {
+                SEARCH_STAT(lmrResearches);
+                score = -search(board, depth - 1, -beta, -alpha, ply + 1, m);
+            }
         } else if (movesSearched == 0) {
             score = -search(board, depth - 1, -beta, -alpha, ply + 1, m);
         } else {
@@ -378,7 +385,7 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
             if (score > alpha && score < beta) score = -search(board, depth - 1, -beta, -alpha, ply + 1, m);
         }
 
-        board.unmakeMove(m, undo);
+        board.unmakeMove(m);
         movesSearched++;
 
         if (timeUp_) return 0;
@@ -390,6 +397,8 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
                 alpha = score;
                 if (isRoot) bestRoot_ = m;
                 if (alpha >= beta) {
+                    SEARCH_STAT(betaCutoffs);
+                    if (movesSearched == 1) SEARCH_STAT(firstMoveCutoffs);
                     if (isQuiet) {
                         history_[m.from()][m.to()] += depth * depth;
                         // Penalize all quiets tried before the cutoff move
@@ -413,18 +422,16 @@ int ThisBot::search(Board& board, int depth, int alpha, int beta, int ply, Move
 
         // Track quiets tried, don't penalize here
         if (isQuiet) {
-            quietsTried.push_back(m);
+            quietsTried.push(m);
         }
     }
 
+    // No legal move was searched: the first legal move is never pruned, so this is mate or stalemate
+    if (movesSearched == 0) return inCheck ? -MATE + ply : 0;
+
     // TT storage with mate score adjustment
-    if (tt.key != key || depth >= tt.depth) {
-        tt.key = key;
-        tt.depth = depth;
-        tt.score = scoreToTT(bestScore, ply);
-        tt.move = bestMove;
-        tt.flag = bestScore <= origAlpha ? 3 : (bestScore >= beta ? 2 : 1);
-    }
+    tt_.store(key, depth, scoreToTT(bestScore, ply), bestMove,
+              bestScore <= origAlpha ? 3 : (bestScore >= beta ? 2 : 1));
 
     return bestScore;
 }
@@ -440,6 +447,10 @@ int ThisBot::searchScore(Board& board, int depth, int hardMs, std::uint64_t maxN
     selDepth_ = 0;
     start_ = std::chrono::steady_clock::now();
     bestRoot_ = Move();
+#if defined(SEARCH_TRACE)
+    trace_.reserve();  // Datagen may search here before any think()
+    trace_.clear();
+#endif
 
     int alpha = -INF, beta = INF;
     int score = search(board, depth, alpha, beta, 0, Move());
@@ -452,16 +463,16 @@ int ThisBot::searchScore(Board& board, int depth, int hardMs, std::uint64_t maxN
 int ThisBot::scoreMoveSearch(Board& board, Move m, int depth, int hardMs, std::uint64_t maxNodes) {
     if (depth <= 1) {
         // fall back to 1-ply static (still from current side POV)
-        auto u = board.makeMove(m);
+        board.makeMove(m);
         int s = -evaluate(board);
-        board.unmakeMove(m, u);
+        board.unmakeMove(m);
         return s;
     }
 
-    auto u = board.makeMove(m);
+    board.makeMove(m);
     // after making m, opponent to move, so negate
     int s = -searchScore(board, depth - 1, hardMs, maxNodes);
-    board.unmakeMove(m, u);
+    board.unmakeMove(m);
     return s;
 }
 
@@ -1,30 +1,138 @@
 // This Bot v0.1
 #include <cstdint>
+#include <cstddef>
 #include <iostream>
 #include <cctype>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <array>
 #include <optional>
 #include <cstring>
+#include <cstdlib>
 #include <chrono>
 #include <vector>
 #include <limits>
 #include <cmath>
 #include <algorithm>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <thread>
 #include <fstream>
 #include <atomic>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <new>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 
+#include "allocaudit.cpp"
 
-#include "bitboard.cpp"
-#include "move.cpp"
-#include "board.cpp"
-#include "evaluate.cpp"
-#include "search.cpp"
-#include "tune.cpp"
-#include "generate.cpp"
-#include "uci.cpp"
+//============================================================================
+// Runtime CPU dispatch
+// A portable x86-64 build (no -march=native) compiles the whole engine once
+// per ISA level, each copy in its own namespace with its own target options,
+// and main() runs the best copy the CPU supports. Targets that already have
+// AVX2, other architectures and -DNO_DISPATCH builds get a single copy.
+//============================================================================
+#if !defined(NO_DISPATCH) && !defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define ENGINE_DISPATCH 1
+#include <cpuid.h>
+#endif
+
+#define ENGINE_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define ENGINE_TARGET_PUSH(isa) ENGINE_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+#define ENGINE_TARGET_POP() ENGINE_PRAGMA(clang attribute pop)
+#else
+#define ENGINE_TARGET_PUSH(isa) ENGINE_PRAGMA(GCC push_options) ENGINE_PRAGMA(GCC target(isa))
+#define ENGINE_TARGET_POP() ENGINE_PRAGMA(GCC pop_options)
+#endif
+
+#if defined(ENGINE_DISPATCH)
+
+// x86-64-v3: AVX2, BMI1/2 (pext slider lookups), POPCNT, LZCNT
+ENGINE_TARGET_PUSH("popcnt,lzcnt,bmi,bmi2,avx,avx2,fma,sse4.2")
+#define ENGINE_ISA_NAME "bmi2"
+#define ENGINE_TARGET_BMI2
+namespace isa_bmi2 {
+#include "engine.cpp"
+}
+#undef ENGINE_TARGET_BMI2
+#undef ENGINE_ISA_NAME
+ENGINE_TARGET_POP()
+
+// x86-64-v2: hardware POPCNT for the eval loops, magic slider lookups
+ENGINE_TARGET_PUSH("popcnt,sse4.2")
+#define ENGINE_ISA_NAME "popcnt"
+namespace isa_popcnt {
+#include "engine.cpp"
+}
+#undef ENGINE_ISA_NAME
+ENGINE_TARGET_POP()
+
+// Baseline x86-64 for everything older
+#define ENGINE_ISA_NAME "generic"
+namespace isa_generic {
+#include "engine.cpp"
+}
+#undef ENGINE_ISA_NAME
+
+// pext is microcoded on AMD before Zen 3 (family 19h): far slower than magics
+static bool hasFastPext() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+    bool amd = ebx == 0x68747541;  // "Auth"enticAMD
+    if (!amd) return true;
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    unsigned family = ((eax >> 8) & 0xF) + ((eax >> 20) & 0xFF);
+    return family >= 0x19;
+}
+
+int main(int argc, char** argv) {
+    __builtin_cpu_init();
+    // THISBOT_CPU=popcnt|generic caps the path, e.g. to test older hosts' code
+    const char* cap = std::getenv("THISBOT_CPU");
+    std::string limit = cap ? cap : "";
+    bool allowBmi2 = limit.empty() || limit == "bmi2";
+    bool allowPopcnt = allowBmi2 || limit == "popcnt";
+
+    if (allowBmi2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2") && hasFastPext())
+        return isa_bmi2::engineMain(argc, argv);
+    if (allowPopcnt && __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("sse4.2"))
+        return isa_popcnt::engineMain(argc, argv);
+    return isa_generic::engineMain(argc, argv);
+}
+
+#else
+
+// One copy, named after the ISA level the compiler targets, as above
+#if defined(__AVX2__) && defined(__BMI2__)
+#define ENGINE_ISA_NAME "bmi2"
+#elif defined(__POPCNT__)
+#define ENGINE_ISA_NAME "popcnt"
+#else
+#define ENGINE_ISA_NAME "generic"
+#endif
+#include "engine.cpp"
+
+int main(int argc, char** argv) { return engineMain(argc, argv); }
+
+#endif
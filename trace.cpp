@@ -0,0 +1,109 @@
+namespace chess {
+
+//============================================================================
+// Search event trace
+// A -DSEARCH_TRACE build records what each search did, not just totals: node
+// enter/exit with ply, depth and window, TT hits, prune decisions and
+// iteration boundaries, as 16-byte events in a ring owned by the ThisBot
+// (so one writer per ring, no locks). The ring keeps the last CAPACITY
+// events; a dump writes them oldest first behind a small header. This file
+// uses only the standard library, so tracereader.cpp builds the offline
+// reader from it without the engine.
+//============================================================================
+enum TraceType : std::uint8_t {
+    TRACE_ENTER,       // info 1 = qsearch; window in alpha/beta; move that led here
+    TRACE_EXIT,        // info = bound (1 exact, 2 lower, 3 upper); score
+    TRACE_TT_HIT,      // info = TT flag, depth = TT depth; score; TT move
+    TRACE_PRUNE,       // info = TracePrune; move pruned, if any
+    TRACE_ITER_START,  // depth; window; stamp = ms since go
+    TRACE_ITER_END,    // info 1 = aborted by time; depth; score; stamp = ms since go
+    TRACE_TYPE_COUNT
+};
+
+enum TracePrune : std::uint8_t {
+    PRUNE_REVERSE_FUTILITY, PRUNE_NULL_MOVE, PRUNE_FUTILITY, PRUNE_MOVE_COUNT, PRUNE_SEE,
+    PRUNE_QDELTA, PRUNE_QSEE, PRUNE_KIND_COUNT
+};
+
+struct TraceEvent {
+    std::uint8_t type;
+    std::uint8_t info;
+    std::uint8_t ply;       // qDepth for qsearch events
+    std::int8_t depth;
+    std::int16_t alpha;
+    std::int16_t beta;
+    std::int16_t score;
+    std::uint16_t move;     // Raw Move
+    std::uint32_t stamp;    // Search nodes so far, except for iteration events
+};
+static_assert(sizeof(TraceEvent) == 16, "trace events are 16 bytes on disk");
+
+// File: header, then `count` events oldest first
+struct TraceFileHeader {
+    char magic[8];             // "TBTRACE1"
+    std::uint32_t eventSize;   // sizeof(TraceEvent)
+    std::uint32_t reserved;
+    std::uint64_t written;     // Events recorded in the search, may exceed count
+    std::uint64_t count;       // Events in this file
+};
+
+class SearchTrace {
+public:
+    static constexpr std::uint64_t CAPACITY = std::uint64_t(1) << 20;  // 16 MB of events
+
+    // Allocated on first use, outside the no-allocation search scope
+    void reserve() {
+        if (!events_) events_.reset(new TraceEvent[CAPACITY]);
+    }
+
+    void clear() { head_.store(0, std::memory_order_relaxed); }
+
+    std::uint64_t written() const { return head_.load(std::memory_order_acquire); }
+
+    inline void push(TraceType type, int info, int ply, int depth, int alpha, int beta, int score,
+                     std::uint16_t move, std::uint32_t stamp) {
+        std::uint64_t h = head_.load(std::memory_order_relaxed);
+        TraceEvent& e = events_[h & (CAPACITY - 1)];
+        e.type = type;
+        e.info = std::uint8_t(info);
+        e.ply = std::uint8_t(ply);
+        e.depth = std::int8_t(std::clamp(depth, -128, 127));
+        e.alpha = std::int16_t(alpha);
+        e.beta = std::int16_t(beta);
+        e.score = std::int16_t(score);
+        e.move = move;
+        e.stamp = stamp;
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    bool dump(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out || !events_) return false;
+        std::uint64_t head = written();
+        std::uint64_t count = std::min(head, CAPACITY);
+        TraceFileHeader h{{'T', 'B', 'T', 'R', 'A', 'C', 'E', '1'}, sizeof(TraceEvent), 0, head, count};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        // Oldest first: the ring's tail to its end, then its start up to head
+        for (std::uint64_t i = head - count; i < head; ) {
+            std::uint64_t slot = i & (CAPACITY - 1);
+            std::uint64_t run = std::min(head - i, CAPACITY - slot);
+            out.write(reinterpret_cast<const char*>(&events_[slot]), std::streamsize(run * sizeof(TraceEvent)));
+            i += run;
+        }
+        return bool(out);
+    }
+
+    static bool load(const std::string& path, TraceFileHeader& h, std::vector<TraceEvent>& events) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+        if (std::memcmp(h.magic, "TBTRACE1", 8) != 0 || h.eventSize != sizeof(TraceEvent)) return false;
+        events.resize(h.count);
+        return bool(in.read(reinterpret_cast<char*>(events.data()), std::streamsize(h.count * sizeof(TraceEvent))));
+    }
+
+private:
+    std::unique_ptr<TraceEvent[]> events_;
+    std::atomic<std::uint64_t> head_{0};
+};
+
+} // namespace chess
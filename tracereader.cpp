@@ -0,0 +1,172 @@
+// Offline reader for search traces dumped by a -DSEARCH_TRACE build
+// ("trace dump <file>", or "trace overrun <file>"). Rebuilds the tree from
+// the enter/exit events and prints its shape: iterations, nodes and
+// branching per ply, fail-high/low rates, prunes, TT hits and the largest
+// subtrees with the moves leading to them.
+//
+// g++ -std=c++17 -O2 -o tracereader tracereader.cpp
+// ./tracereader <trace.bin> [top-n]
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+
+#include "trace.cpp"
+
+using namespace chess;
+
+static std::string moveName(std::uint16_t raw) {
+    if (raw == 0) return "null";
+    auto square = [](int sq) { return std::string{char('a' + (sq & 7)), char('1' + (sq >> 3))}; };
+    std::string s = square(raw & 0x3F) + square((raw >> 6) & 0x3F);
+    if (((raw >> 12) & 3) == 1) s += "nbrq"[(raw >> 14) & 3];  // MT_PROMOTION
+    return s;
+}
+
+static double pct(std::uint64_t part, std::uint64_t whole) {
+    return whole ? 100.0 * double(part) / double(whole) : 0.0;
+}
+
+struct PlyShape {
+    std::uint64_t nodes = 0, qnodes = 0, children = 0, parents = 0;
+    std::uint64_t bound[4] = {};  // Exits by bound: 1 exact, 2 lower (fail high), 3 upper (fail low)
+};
+
+struct Subtree {
+    std::uint64_t nodes;
+    int ply, depth, alpha, beta, score;
+    std::string path;
+};
+
+struct Frame {
+    std::uint64_t startNodes;   // Nodes entered before this one
+    std::uint64_t children = 0;
+    std::uint16_t move;
+    std::uint8_t ply;
+    std::int8_t depth;
+    std::int16_t alpha, beta;
+    bool qsearch;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <trace.bin> [top-n]" << std::endl;
+        return 2;
+    }
+    size_t topN = argc > 2 ? size_t(std::max(1, std::atoi(argv[2]))) : 10;
+
+    TraceFileHeader header;
+    std::vector<TraceEvent> events;
+    if (!SearchTrace::load(argv[1], header, events)) {
+        std::cerr << argv[1] << ": not a readable search trace" << std::endl;
+        return 1;
+    }
+    std::cout << argv[1] << ": " << header.count << " events";
+    if (header.written > header.count)
+        std::cout << " (the last of " << header.written << "; earlier ones were overwritten)";
+    std::cout << std::endl;
+
+    std::vector<PlyShape> plies(256);
+    std::vector<Frame> stack;
+    std::vector<Subtree> top;
+    std::uint64_t typeCount[TRACE_TYPE_COUNT] = {};
+    std::uint64_t prunes[PRUNE_KIND_COUNT] = {};
+    std::uint64_t ttHits[4] = {};
+    std::uint64_t entered = 0, unmatched = 0;
+    size_t maxStack = 0;
+    std::uint64_t iterNodes = 0, iterQnodes = 0;
+
+    for (const TraceEvent& e : events) {
+        if (e.type >= TRACE_TYPE_COUNT) { ++unmatched; continue; }
+        ++typeCount[e.type];
+        switch (e.type) {
+        case TRACE_ENTER: {
+            bool q = e.info == 1;
+            // qsearch events carry their qDepth: a qsearch root shares its search node's ply
+            int ply = q ? (stack.empty() ? 0 : stack.back().ply + (stack.back().qsearch ? 1 : 0)) : e.ply;
+            if (q) ++plies[ply].qnodes, ++iterQnodes;
+            else ++plies[ply].nodes, ++iterNodes;
+            if (!stack.empty() && !q) ++stack.back().children;
+            stack.push_back({entered++, 0, e.move, std::uint8_t(ply), e.depth, e.alpha, e.beta, q});
+            maxStack = std::max(maxStack, stack.size());
+            break;
+        }
+        case TRACE_EXIT: {
+            // The ring may start mid-tree: exits of nodes entered before it are skipped
+            if (stack.empty()) { ++unmatched; break; }
+            Frame f = stack.back();
+            stack.pop_back();
+            PlyShape& s = plies[f.ply];
+            if (e.info < 4) ++s.bound[e.info];
+            if (!f.qsearch && f.children) { s.children += f.children; ++s.parents; }
+
+            std::uint64_t size = entered - f.startNodes;
+            if (!f.qsearch && (top.size() < topN || size > top.back().nodes)) {
+                std::string path;
+                for (const Frame& up : stack)
+                    if (!up.qsearch && up.ply > 0) path += moveName(up.move) + " ";
+                if (f.ply > 0) path += moveName(f.move);
+                top.push_back({size, f.ply, f.depth, f.alpha, f.beta, e.score, path});
+                std::sort(top.begin(), top.end(), [](const Subtree& a, const Subtree& b) { return a.nodes > b.nodes; });
+                if (top.size() > topN) top.pop_back();
+            }
+            break;
+        }
+        case TRACE_TT_HIT:
+            if (e.info < 4) ++ttHits[e.info];
+            break;
+        case TRACE_PRUNE:
+            if (e.info < PRUNE_KIND_COUNT) ++prunes[e.info];
+            break;
+        case TRACE_ITER_START:
+            iterNodes = iterQnodes = 0;
+            std::cout << "iteration " << int(e.depth) << " window [" << e.alpha << ", " << e.beta
+                      << "] at " << e.stamp << " ms" << std::endl;
+            break;
+        case TRACE_ITER_END:
+            std::cout << "  depth " << int(e.depth) << " score " << e.score << " at " << e.stamp << " ms, "
+                      << iterNodes << " nodes + " << iterQnodes << " qnodes"
+                      << (e.info == 1 ? " (aborted by time)" : "") << std::endl;
+            break;
+        }
+    }
+
+    std::cout << "\nnodes " << typeCount[TRACE_ENTER] << ", max stack " << maxStack
+              << ", unmatched exits " << unmatched << ", still open " << stack.size() << std::endl;
+
+    // Branching counts search children of nodes that had any; fail rates cover search and qsearch exits
+    std::cout << "\nply      nodes     qnodes  branching  fail-high%  fail-low%  exact%" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t p = 0; p < plies.size(); ++p) {
+        const PlyShape& s = plies[p];
+        if (!s.nodes && !s.qnodes) continue;
+        std::uint64_t exits = s.bound[1] + s.bound[2] + s.bound[3];
+        std::cout << std::setw(3) << p << std::setw(11) << s.nodes << std::setw(11) << s.qnodes
+                  << std::setw(11) << (s.parents ? double(s.children) / double(s.parents) : 0.0)
+                  << std::setw(12) << pct(s.bound[2], exits) << std::setw(11) << pct(s.bound[3], exits)
+                  << std::setw(8) << pct(s.bound[1], exits) << std::endl;
+    }
+
+    static const char* const PRUNE_NAMES[PRUNE_KIND_COUNT] = {
+        "reverse futility", "null move", "futility", "move count", "see", "qdelta", "qsee"
+    };
+    std::cout << "\nprunes:";
+    for (int k = 0; k < PRUNE_KIND_COUNT; ++k) std::cout << (k ? ", " : " ") << PRUNE_NAMES[k] << " " << prunes[k];
+    std::cout << "\ntt hits: " << typeCount[TRACE_TT_HIT] << " (exact " << ttHits[1] << ", lower " << ttHits[2]
+              << ", upper " << ttHits[3] << ")" << std::endl;
+
+    std::cout << "\nlargest subtrees:" << std::endl;
+    for (const Subtree& t : top) {
+        std::cout << "  " << t.nodes << " nodes  ply " << t.ply << " depth " << t.depth
+                  << " window [" << t.alpha << ", " << t.beta << "] score " << t.score
+                  << "  " << (t.path.empty() ? "(root)" : t.path) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+namespace chess {
+
+//============================================================================
+// Transposition table
+// Each entry is two 64-bit words: the packed payload and (key ^ payload).
+// A reader accepts an entry only if the XOR reproduces its key, so a torn
+// write from another thread - or another process sharing the table through
+// a POSIX shared-memory segment - reads as a miss instead of a bad move.
+//============================================================================
+struct TTData {
+    int depth;
+    int score;
+    Move move;
+    std::uint8_t flag; // 1 exact, 2 lower, 3 upper
+};
+
+struct TTEntry {
+    std::uint64_t keyXor = 0;  // key ^ data
+    std::uint64_t data = 0;    // [move:16][score:16][depth:16][flag:8]
+
+    static FORCE_INLINE std::uint64_t pack(int depth, int score, Move move, std::uint8_t flag) {
+        return std::uint64_t(move.raw())
+             | (std::uint64_t(std::uint16_t(score)) << 16)
+             | (std::uint64_t(std::uint16_t(depth)) << 32)
+             | (std::uint64_t(flag) << 48);
+    }
+
+    static FORCE_INLINE TTData unpack(std::uint64_t d) {
+        return { std::int16_t(d >> 32), std::int16_t(d >> 16),
+                 Move::fromRaw(std::uint16_t(d)), std::uint8_t(d >> 48) };
+    }
+};
+
+class TranspositionTable {
+public:
+    TranspositionTable() = default;
+    ~TranspositionTable() { unmapShared(); }
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Private table of the largest power-of-two entry count that fits in mbSize
+    void resize(size_t mbSize) {
+        unmapShared();
+        allocate(entriesFor(mbSize));
+    }
+
+    void clear() {
+        std::memset(static_cast<void*>(table_), 0, size_ * sizeof(TTEntry));
+    }
+
+    size_t size() const { return size_; }
+    size_t sizeMB() const { return size_ * sizeof(TTEntry) / (1024 * 1024); }
+    bool isShared() const { return shm_ != nullptr; }
+    const std::string& sharedName() const { return shmName_; }
+
+    FORCE_INLINE bool probe(std::uint64_t key, TTData& out) const {
+        const TTEntry& e = table_[key & (size_ - 1)];
+        std::uint64_t d = e.data;
+        if ((e.keyXor ^ d) != key) return false;
+        out = TTEntry::unpack(d);
+        return true;
+    }
+
+    // Replace unless the slot holds the same position searched deeper
+    FORCE_INLINE void store(std::uint64_t key, int depth, int score, Move move, std::uint8_t flag) {
+        TTEntry& e = table_[key & (size_ - 1)];
+        std::uint64_t old = e.data;
+        if ((e.keyXor ^ old) == key && depth < std::int16_t(old >> 32)) return;
+        std::uint64_t d = TTEntry::pack(depth, score, move, flag);
+        e.data = d;
+        e.keyXor = key ^ d;
+    }
+
+    int hashFull() const {
+        // Sample first 1000 entries to estimate hash table usage
+        int used = 0;
+        size_t sample = std::min(size_, size_t(1000));
+        for (size_t i = 0; i < sample; ++i) {
+            if (table_[i].keyXor != 0) ++used;
+        }
+        return static_cast<int>(used * 1000 / sample);
+    }
+
+    //========================================================================
+    // Shared-memory backing (POSIX shm_open + mmap)
+    //
+    // Ownership rules:
+    //  - The first process to open `name` creates it (O_EXCL), sizes it from
+    //    mbSize, writes the header and publishes it by setting `ready`.
+    //    Later processes attach at whatever size the creator chose.
+    //  - The segment outlives every process: nobody unlinks it on exit,
+    //    since a crashed owner could otherwise pull it out from under the
+    //    others. Remove it with `rm /dev/shm/<name>`.
+    //  - Entries are only ever written with the XOR scheme above, so a
+    //    process dying mid-store leaves at worst one entry that fails
+    //    verification.
+    //  - A creator dying before `ready` leaves a stale segment: still too
+    //    small, or unpublished, after the attacher's one-second wait. The
+    //    attacher unlinks it and retries once as creator. A published segment
+    //    with a foreign header is refused and left alone.
+    //  - The segment is created owner-only (0600): processes of other users
+    //    cannot attach, so none can write into another user's table.
+    //========================================================================
+    bool attachShared(const std::string& name, size_t mbSize) {
+        bool stale = false;
+        if (attachSharedOnce(name, mbSize, stale)) return true;
+        return stale && unlinkShared(name) && attachSharedOnce(name, mbSize, stale);
+    }
+
+    // Unmap the segment and fall back to a private table of the same size
+    void detachShared() {
+        if (!shm_) return;
+        size_t entries = size_;
+        unmapShared();
+        allocate(entries);
+    }
+
+private:
+    bool attachSharedOnce(const std::string& name, size_t mbSize, bool& stale) {
+        stale = false;
+#if defined(__unix__) || defined(__APPLE__)
+        if (name.empty()) return false;
+
+        bool creator = true;
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0 && errno == EEXIST) {
+            creator = false;
+            fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        }
+        if (fd < 0) return false;
+
+        size_t bytes = 0;
+        size_t entries = 0;
+        if (creator) {
+            entries = entriesFor(mbSize);
+            bytes = sizeof(ShmHeader) + entries * sizeof(TTEntry);
+            if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                ::close(fd);
+                ::shm_unlink(name.c_str());
+                return false;
+            }
+        } else {
+            // Give a concurrent creator a moment to size and publish the segment
+            struct stat st{};
+            for (int i = 0; i < 100; ++i) {
+                if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ShmHeader)) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            bytes = static_cast<size_t>(st.st_size);
+            if (bytes < sizeof(ShmHeader)) { ::close(fd); stale = true; return false; }
+        }
+
+        void* mem = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) return false;
+
+        auto* header = static_cast<ShmHeader*>(mem);
+        if (creator) {
+            // ftruncate zero-fills, so the table already reads as empty
+            header->magic = SHM_MAGIC;
+            header->entrySize = sizeof(TTEntry);
+            header->entries = entries;
+            header->ready.store(1, std::memory_order_release);
+        } else {
+            for (int i = 0; i < 100 && !header->ready.load(std::memory_order_acquire); ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (!header->ready.load(std::memory_order_acquire)) {
+                ::munmap(mem, bytes);
+                stale = true;
+                return false;
+            }
+            entries = header->entries;
+            bool valid = header->magic == SHM_MAGIC
+                      && header->entrySize == sizeof(TTEntry)
+                      && entries > 0 && (entries & (entries - 1)) == 0
+                      && sizeof(ShmHeader) + entries * sizeof(TTEntry) <= bytes;
+            if (!valid) { ::munmap(mem, bytes); return false; }
+        }
+
+        unmapShared();
+        heap_.clear();
+        heap_.shrink_to_fit();
+        shm_ = mem;
+        shmBytes_ = bytes;
+        shmName_ = name;
+        table_ = reinterpret_cast<TTEntry*>(static_cast<char*>(mem) + sizeof(ShmHeader));
+        size_ = entries;
+        return true;
+#else
+        (void)name; (void)mbSize;
+        return false;
+#endif
+    }
+
+    static bool unlinkShared(const std::string& name) {
+#if defined(__unix__) || defined(__APPLE__)
+        return !name.empty() && ::shm_unlink(name.c_str()) == 0;
+#else
+        (void)name;
+        return false;
+#endif
+    }
+
+    static constexpr std::uint64_t SHM_MAGIC = 0x5468697342545431ULL; // "ThisBTT1"
+
+    struct alignas(64) ShmHeader {
+        std::uint64_t magic;
+        std::uint64_t entrySize;
+        std::uint64_t entries;
+        std::atomic<std::uint32_t> ready;
+    };
+
+    std::vector<TTEntry> heap_;
+    TTEntry* table_ = nullptr;
+    size_t size_ = 0;
+    void* shm_ = nullptr;
+    size_t shmBytes_ = 0;
+    std::string shmName_;
+
+    static size_t entriesFor(size_t mbSize) {
+        size_t numEntries = mbSize * 1024 * 1024 / sizeof(TTEntry);
+        // Round down to power of 2 for efficient masking
+        size_t power = 1;
+        while (power * 2 <= numEntries) power *= 2;
+        return power;
+    }
+
+    void unmapShared() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (!shm_) return;
+        ::munmap(shm_, shmBytes_);
+        shm_ = nullptr;
+        shmBytes_ = 0;
+        shmName_.clear();
+        table_ = nullptr;
+        size_ = 0;
+#endif
+    }
+
+    void allocate(size_t numEntries) {
+        heap_.clear();
+        heap_.resize(numEntries);
+        table_ = heap_.data();
+        size_ = numEntries;
+    }
+};
+
+} // namespace chess
@@ -29,6 +29,7 @@ public:
         std::uniform_int_distribution<int> bit(0, 1);
 
         for (int iter = 0; iter < cfg_.iterations; ++iter) {
+            AllocScope allocs(true);
             double ck = cfg_.c / std::pow(iter + 1.0, cfg_.gamma);
             double ak = cfg_.a / std::pow(cfg_.A + iter + 1.0, cfg_.alpha);
 
@@ -64,6 +65,7 @@ public:
                           << " ck " << ck
                           << std::endl;
             }
+            allocs.report(std::cout, "info string ", "spsa iter", iter + 1);
         }
         return theta_;
     }
@@ -158,14 +160,13 @@ private:
 
     // CHANGE: avoid redundant generateLegalMoves() each ply; only do it if think() fails.
     double playSingleGame(const EvalParams& whiteParams, const EvalParams& blackParams, bool plusIsWhite, unsigned seed) const {
-        Board board;
+        Board::StateStack states;
+        Board board(states);
         board.reset();
 
-        ThisBot white(std::make_shared<EvalParams>(whiteParams));
-        ThisBot black(std::make_shared<EvalParams>(blackParams));
         // Use a small transposition table during tuning to avoid OOM when many games run in parallel
-        white.setHashSize(8);  // MB
-        black.setHashSize(8);  // MB
+        ThisBot white(std::make_shared<EvalParams>(whiteParams), 8);  // MB
+        ThisBot black(std::make_shared<EvalParams>(blackParams), 8);  // MB
 
         std::mt19937 rng(seed);
 
@@ -177,7 +178,7 @@ private:
             std::uniform_int_distribution<int> dist(0, moves.size() - 1);
             Move randMove = moves[dist(rng)];
             board.makeMove(randMove);
-            if (board.isCheckmate() || board.isStalemate()) break;
+            if (board.gameState() != Board::GameState::Ongoing) break;
         }
 
         double result = 0.0;
@@ -198,14 +199,14 @@ private:
                 break;
             }
 
-            auto undo = board.makeMove(mv);
-            (void)undo;
+            board.makeMove(mv);
 
-            if (board.isCheckmate()) {
+            Board::GameState state = board.gameState();
+            if (state == Board::GameState::Checkmate) {
                 result = board.sideToMove_ == WHITE ? -1.0 : 1.0;
                 break;
             }
-            if (board.isStalemate() || board.halfmove_ >= 100) {
+            if (state != Board::GameState::Ongoing) {
                 result = 0.0;
                 break;
             }
@@ -289,8 +290,10 @@ public:
                     if (idx >= seeds.size()) break;
 
                     for (int g = 0; g < cfg_.gamesPerSeed; ++g) {
+                        AllocScope allocs;
                         auto samples = playGame(seeds[idx], evaluator, rng);
                         writeSamples(samples);
+                        allocs.report(std::cout, "info string ", "gen game");
                     }
                 }
             });
@@ -323,9 +326,9 @@ private:
             scored.reserve(moves.size());
             for (int i = 0; i < moves.size(); ++i) {
                 Move m = moves[i];
-                auto undo = board.makeMove(m);
+                board.makeMove(m);
                 int score = -evaluator.evaluateForTuning(board);
-                board.unmakeMove(m, undo);
+                board.unmakeMove(m);
                 scored.push_back({score, m});
             }
 
@@ -342,9 +345,9 @@ private:
         pre.reserve(moves.size());
         for (int i = 0; i < moves.size(); ++i) {
             Move m = moves[i];
-            auto undo = board.makeMove(m);
+            board.makeMove(m);
             int s = -evaluator.evaluateForTuning(board);
-            board.unmakeMove(m, undo);
+            board.unmakeMove(m);
             pre.push_back({s, m});
         }
 
@@ -395,7 +398,8 @@ private:
 
     // CHANGE: reuse pickMove()'s search scores for labels when label config matches playout config.
     std::vector<PositionEvalSample> playGame(const std::string& seedFen, ThisBot& evaluator, std::mt19937& rng) const {
-        Board board;
+        Board::StateStack states;
+        Board board(states);
         board.setFEN(seedFen);
 
         // Apply random opening moves
@@ -406,7 +410,7 @@ private:
             std::uniform_int_distribution<int> dist(0, moves.size() - 1);
             Move mv = moves[dist(rng)];
             board.makeMove(mv);
-            if (board.isCheckmate() || board.isStalemate()) break;
+            if (board.gameState() != Board::GameState::Ongoing) break;
         }
 
         std::vector<PositionEvalSample> collected;
@@ -447,7 +451,7 @@ private:
 
             board.makeMove(pr.move);
 
-            if (board.isCheckmate() || board.isStalemate() || board.halfmove_ >= 100) break;
+            if (board.gameState() != Board::GameState::Ongoing) break;
         }
 
         if (collected.size() > static_cast<std::size_t>(cfg_.positionsPerGame)) {
@@ -522,11 +526,14 @@ public:
         std::atomic<int> gamesCompleted{0};
         
         auto playGame = [&](unsigned gameSeed) {
-            Board board;
+            AllocScope allocs;
+            Board::StateStack states;
+            Board board(states);
             board.reset();
             
-            ThisBot white(params_);
-            ThisBot black(params_);
+            // Small tables, as in SPSA: one pair of engines per concurrent game
+            ThisBot white(params_, 8);  // MB
+            ThisBot black(params_, 8);  // MB
             
             std::mt19937 localRng(gameSeed);
             std::vector<std::string> gameFens;
@@ -538,7 +545,7 @@ public:
                 if (moves.size() == 0) break;
                 std::uniform_int_distribution<int> dist(0, moves.size() - 1);
                 board.makeMove(moves[dist(localRng)]);
-                if (board.isCheckmate() || board.isStalemate()) break;
+                if (board.gameState() != Board::GameState::Ongoing) break;
             }
             
             double result = 0.5;
@@ -565,11 +572,12 @@ public:
                 
                 board.makeMove(mv);
                 
-                if (board.isCheckmate()) {
+                Board::GameState state = board.gameState();
+                if (state == Board::GameState::Checkmate) {
                     result = board.sideToMove_ == WHITE ? 0.0 : 1.0;
                     break;
                 }
-                if (board.isStalemate() || board.halfmove_ >= 100) {
+                if (state != Board::GameState::Ongoing) {
                     result = 0.5;
                     break;
                 }
@@ -589,6 +597,7 @@ public:
             if (completed % 10 == 0) {
                 std::cout << "info string texel games " << completed << "/" << cfg_.numGames << std::endl;
             }
+            allocs.report(std::cout, "info string ", "texel game", completed);
         };
         
         std::vector<std::thread> threads;
@@ -661,6 +670,7 @@ public:
         const double epsilon = 0.5;
         
         for (int iter = 0; iter < cfg_.iterations; ++iter) {
+            AllocScope allocs(true);
             std::vector<double> gradients(pstRefs.size(), 0.0);
             
             // Compute numerical gradients
@@ -697,6 +707,7 @@ public:
                           << " error " << newError 
                           << " lr " << lr << std::endl;
             }
+            allocs.report(std::cout, "info string ", "texel iter", iter + 1);
             
             // Early stopping if not improving
             if (iter > 20 && newError >= baseError * 0.999) {
@@ -722,16 +733,16 @@ private:
     double computeError() const {
         if (positions_.empty()) return 1.0;
         
-        // Create an engine with current parameters for evaluation
-        ThisBot evalEngine(params_);
+        // Static evaluator with current parameters - no search state or TT
+        Evaluator evaluator(params_);
+        Board board;
         double totalError = 0.0;
         
         for (const auto& pos : positions_) {
-            Board board;
             board.setFEN(pos.fen);
             
             // Use the REAL evaluation function
-            int eval = evalEngine.evaluateForTuning(board);
+            int eval = evaluator.evaluate(board);
             
             double predicted = sigmoid(eval);
             double error = pos.result - predicted;
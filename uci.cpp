@@ -1,11 +1,13 @@
-int main() {
+// Entry point of the UCI loop, run by engineMain() (engine.cpp)
+int uciMain() {
     using namespace chess;
     
     // Disable buffering for immediate output to GUI
     std::cout.setf(std::ios::unitbuf);
     std::cin.tie(nullptr);
     
-    Board board;
+    Board::StateStack states;
+    Board board(states);
     ThisBot bot;
     bool debugMode = false;
     
@@ -21,31 +23,69 @@ int main() {
         return out;
     };
 
+    // OPTIMIZATION: GUIs resend the whole game with every "position". When a
+    // command repeats the previous one's start and moves and the board is
+    // still where that left it, only the new moves are applied.
+    std::string lastStart;                // "startpos" or the FEN; empty = no cache
+    std::vector<std::string> lastMoves;   // Move tokens applied after it
+    std::uint64_t lastHash = 0;           // board.hash_ after them
+
+    // "perft/divide/perftdebug <depth> [threads <n>] [hash <mb>]"
+    auto parsePerftOptions = [](const std::vector<std::string>& t, int& threads, int& hashMb) {
+        for (size_t i = 2; i + 1 < t.size(); i += 2) {
+            if (t[i] == "threads") threads = std::max(1, std::stoi(t[i + 1]));
+            else if (t[i] == "hash") hashMb = std::max(0, std::stoi(t[i + 1]));
+        }
+    };
+
     auto setPosition = [&](const std::vector<std::string>& tokens) {
         if (tokens.size() < 2) return;
         size_t idx = 1;
+        std::string start;
         if (tokens[idx] == "startpos") {
-            board.reset();
+            start = "startpos";
             ++idx;
         } else if (tokens[idx] == "fen") {
-            std::string fen;
             ++idx;
             while (idx < tokens.size() && tokens[idx] != "moves") {
-                if (!fen.empty()) fen += ' ';
-                fen += tokens[idx++];
+                if (!start.empty()) start += ' ';
+                start += tokens[idx++];
             }
-            if (!fen.empty()) board.setFEN(fen);
         }
 
-        auto applyMoves = [&](size_t startIdx) {
-            for (size_t i = startIdx; i < tokens.size(); ++i) {
-                auto mv = board.parseUCI(tokens[i]);
-                if (mv) board.makeMove(*mv);
+        size_t movesAt = tokens.size();
+        for (; idx < tokens.size(); ++idx) {
+            if (tokens[idx] == "moves") { movesAt = idx + 1; break; }
+        }
+
+        size_t applied = 0;
+        bool extends = !lastStart.empty() && start == lastStart && board.hash_ == lastHash &&
+                       tokens.size() - movesAt >= lastMoves.size() &&
+                       std::equal(lastMoves.begin(), lastMoves.end(), tokens.begin() + movesAt);
+        if (extends) {
+            applied = lastMoves.size();
+        } else {
+            lastStart.clear();
+            lastMoves.clear();
+            if (start == "startpos") {
+                board.reset();
+            } else if (!start.empty()) {
+                FenError err = board.parseFEN(start);
+                if (err != FenError::None) {
+                    std::cout << "info string invalid fen (" << fenErrorString(err) << "): " << start << std::endl;
+                    return;
+                }
             }
-        };
+        }
 
-        for (; idx < tokens.size(); ++idx) {
-            if (tokens[idx] == "moves") { applyMoves(idx + 1); break; }
+        for (size_t i = movesAt + applied; i < tokens.size(); ++i) {
+            auto mv = board.parseUCI(tokens[i]);
+            if (mv) board.makeMove(*mv);
+            lastMoves.push_back(tokens[i]);
+        }
+        if (!start.empty()) {
+            lastStart = start;
+            lastHash = board.hash_;
         }
     };
 
@@ -56,12 +96,14 @@ int main() {
         bool infinite = false;
         bool ponder = false;
         bool perftMode = false;
-        int perftDepth = 0;
+        int perftDepth = 0, perftThreads = 1, perftHashMb = 0;
 
         for (size_t i = 1; i < t.size(); ++i) {
             if (t[i] == "infinite") infinite = true;
             else if (t[i] == "ponder") ponder = true;
             else if (t[i] == "perft" && i + 1 < t.size()) { perftMode = true; perftDepth = std::stoi(t[++i]); }
+            else if (t[i] == "threads" && i + 1 < t.size()) perftThreads = std::max(1, std::stoi(t[++i]));
+            else if (t[i] == "hash" && i + 1 < t.size()) perftHashMb = std::max(0, std::stoi(t[++i]));
             else if (i + 1 < t.size()) {
                 if (t[i] == "movetime") movetime = std::stoi(t[++i]);
                 else if (t[i] == "wtime") wtime = std::stoi(t[++i]);
@@ -77,12 +119,20 @@ int main() {
 
         // Handle perft command within go
         if (perftMode) {
+            AllocScope allocs(true);
+            PerfCounters counters;
             auto startTime = std::chrono::steady_clock::now();
-            std::uint64_t total = perft(board, perftDepth);
+            counters.start();
+            std::uint64_t total = perftThreads > 1 || perftHashMb > 0
+                ? perftParallel(board, perftDepth, perftThreads, perftHashMb)
+                : perft(board, perftDepth);
+            counters.stop();
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::steady_clock::now() - startTime).count();
             auto nps = elapsed > 0 ? (total * 1000ULL) / elapsed : 0;
             std::cout << "info nodes " << total << " time " << elapsed << " nps " << nps << std::endl;
+            counters.report(std::cout, "info string ", double(total), "node");
+            allocs.report(std::cout, "info string ", "perft");
             std::cout << "bestmove 0000" << std::endl;
             return;
         }
@@ -130,7 +180,9 @@ int main() {
             hardMs = 5000;
         }
 
+        AllocScope allocs;
         Move best = bot.think(board, softMs, hardMs, depth, nodes);
+        allocs.report(std::cout, "info string ", "go");
         std::cout << "bestmove " << board.moveToUCI(best) << std::endl;
     };
 
@@ -164,10 +216,20 @@ int main() {
                 std::cout << "info string Hash set to " << mbSize << " MB" << std::endl;
             }
         } else if (lowerName == "clear hash") {
-            bot.setHashSize(bot.getHashSize());  // Clear by resizing to same size
+            bot.clearHash();  // Also wipes a shared table for every attached process
             if (debugMode) {
                 std::cout << "info string Hash cleared" << std::endl;
             }
+        } else if (lowerName == "sharedhash") {
+            // POSIX shared-memory segment name, e.g. /thisbot-tt; empty detaches
+            if (value.empty() || value == "<empty>") {
+                bot.detachSharedHash();
+                std::cout << "info string SharedHash detached, using private " << bot.getHashSize() << " MB table" << std::endl;
+            } else if (bot.setSharedHash(value)) {
+                std::cout << "info string SharedHash attached to " << value << " (" << bot.getHashSize() << " MB)" << std::endl;
+            } else {
+                std::cout << "info string SharedHash unable to attach " << value << ", keeping current table" << std::endl;
+            }
         }
         // Other options silently ignored for compatibility
     };
@@ -175,6 +237,7 @@ int main() {
     auto printUciOptions = []() {
         std::cout << "option name Hash type spin default 128 min 1 max 16384" << std::endl;
         std::cout << "option name Clear Hash type button" << std::endl;
+        std::cout << "option name SharedHash type string default <empty>" << std::endl;
         // Add more options here as needed
     };
 
@@ -197,6 +260,8 @@ int main() {
             std::cout << "id name " << ENGINE_NAME << std::endl;
             std::cout << "id author " << ENGINE_AUTHOR << std::endl;
             printUciOptions();
+            std::cout << "info string cpu path " << ENGINE_ISA_NAME
+                      << ", sliders " << Sliders::Active::NAME << std::endl;
             std::cout << "uciok" << std::endl;
         }
         else if (cmd == "debug") {
@@ -216,8 +281,9 @@ int main() {
         }
         else if (cmd == "ucinewgame") {
             board.reset();
-            // Clear hash table for new game
-            bot.setHashSize(bot.getHashSize());
+            lastStart.clear();
+            // Clear hash table for new game (a shared table is left to its other users)
+            if (!bot.hashShared()) bot.clearHash();
         }
         else if (cmd == "position") {
             setPosition(tokens);
@@ -241,22 +307,106 @@ int main() {
         else if (cmd == "perft") {
             if (tokens.size() > 1) {
                 int d = std::stoi(tokens[1]);
+                int threads = 1, hashMb = 0;
+                parsePerftOptions(tokens, threads, hashMb);
+                AllocScope allocs(true);
+                PerfCounters counters;
                 auto startTime = std::chrono::steady_clock::now();
-                std::uint64_t total = perft(board, d);
+                counters.start();
+                std::uint64_t total = threads > 1 || hashMb > 0
+                    ? perftParallel(board, d, threads, hashMb)
+                    : perft(board, d);
+                counters.stop();
                 auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
                     std::chrono::steady_clock::now() - startTime).count();
                 auto nps = elapsed > 0 ? (total * 1000ULL) / elapsed : 0;
                 std::cout << "Nodes: " << total << std::endl;
                 std::cout << "Time: " << elapsed << " ms" << std::endl;
                 std::cout << "NPS: " << nps << std::endl;
+                counters.report(std::cout, "", double(total), "node");
+                allocs.report(std::cout, "", "perft");
             }
         }
         else if (cmd == "divide") {
             if (tokens.size() > 1) {
                 int d = std::stoi(tokens[1]);
-                perftDivide(board, d);
+                int threads = 1, hashMb = 0;
+                parsePerftOptions(tokens, threads, hashMb);
+                AllocScope allocs(true);
+                PerfCounters counters;
+                counters.start();
+                std::uint64_t total = perftDivide(board, d, threads, hashMb);
+                counters.stop();
+                counters.report(std::cout, "", double(total), "node");
+                allocs.report(std::cout, "", "divide");
             }
         }
+        else if (cmd == "perftdebug") {
+            if (tokens.size() > 1) {
+                int d = std::stoi(tokens[1]);
+                int threads = 1, hashMb = 0;
+                parsePerftOptions(tokens, threads, hashMb);
+                auto startTime = std::chrono::steady_clock::now();
+                std::uint64_t total = perftDebug(board, d, threads);
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - startTime).count();
+                std::cout << "Nodes: " << total << " (state verified at every node)" << std::endl;
+                std::cout << "Time: " << elapsed << " ms" << std::endl;
+            }
+        }
+        else if (cmd == "perftsuite") {
+            if (tokens.size() > 1) {
+                int maxDepth = tokens.size() > 2 ? std::stoi(tokens[2]) : 99;
+                int threads = tokens.size() > 3 ? std::stoi(tokens[3])
+                                                : int(std::thread::hardware_concurrency());
+                perftSuite(tokens[1], maxDepth, std::max(1, threads));
+            }
+        }
+        else if (cmd == "stats") {
+            // stats [reset]: search counters summed over every go since the last reset
+#if defined(SEARCH_STATS)
+            if (tokens.size() > 1 && tokens[1] == "reset") bot.clearStats();
+            else bot.totalStats().print(std::cout, "info string ");
+#else
+            std::cout << "info string stats: build with -DSEARCH_STATS" << std::endl;
+#endif
+        }
+        else if (cmd == "trace") {
+            // trace dump <file> | trace overrun <file>|off
+#if defined(SEARCH_TRACE)
+            if (tokens.size() > 2 && tokens[1] == "dump") {
+                bool ok = bot.trace().dump(tokens[2]);
+                std::cout << "info string trace: " << (ok ? "dumped " : "cannot write ")
+                          << std::min(bot.trace().written(), SearchTrace::CAPACITY) << " of "
+                          << bot.trace().written() << " events to " << tokens[2] << std::endl;
+            } else if (tokens.size() > 2 && tokens[1] == "overrun") {
+                bot.setTraceOverrunPath(tokens[2] == "off" ? "" : tokens[2]);
+            } else {
+                std::cout << "info string trace: dump <file> | overrun <file>|off" << std::endl;
+            }
+#else
+            std::cout << "info string trace: build with -DSEARCH_TRACE" << std::endl;
+#endif
+        }
+        else if (cmd == "perfcounters") {
+            // perfcounters [on|off]: hardware counters after perft, divide, perftsuite and bench
+            if (tokens.size() > 1) PerfCounters::enabled = tokens[1] == "on";
+            std::cout << "perfcounters " << (PerfCounters::enabled ? "on" : "off") << std::endl;
+            PerfCounters probe;
+            if (PerfCounters::enabled && !probe.available()) probe.report(std::cout, "", 1, "op");
+        }
+        else if (cmd == "sliderbench") {
+            int reps = tokens.size() > 1 ? std::stoi(tokens[1]) : 20;
+            sliderBench(reps);
+        }
+        else if (cmd == "fenbench") {
+            int reps = tokens.size() > 1 ? std::stoi(tokens[1]) : 10;
+            fenBench(reps);
+        }
+        else if (cmd == "boardbench") {
+            int reps = tokens.size() > 1 ? std::stoi(tokens[1]) : 10;
+            boardBench(reps);
+        }
         else if (cmd == "fen") {
             std::cout << board.toFEN() << std::endl;
         }
@@ -392,13 +542,22 @@ int main() {
             generator.run();
         }
         else if (cmd == "bench") {
-            // Simple benchmark - search starting position to fixed depth
-            board.reset();
-            auto startTime = std::chrono::steady_clock::now();
-            bot.think(board, 0, 0, 10, 0);  // depth 10, no time limit
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - startTime).count();
-            std::cout << "Bench completed in " << elapsed << " ms" << std::endl;
+            // bench [depth] [hash] [threads] [file], or bench nodes <n> [hash] [threads] [file];
+            // "Nodes searched" is the signature
+            int depth = 8;
+            std::uint64_t maxNodes = 0;
+            size_t arg = 2;
+            if (tokens.size() > 2 && tokens[1] == "nodes") {
+                maxNodes = std::max<std::uint64_t>(1, std::stoull(tokens[2]));
+                depth = 64;  // Bounded by the node limit
+                arg = 3;
+            } else if (tokens.size() > 1) {
+                depth = std::stoi(tokens[1]);
+            }
+            int hashMb = tokens.size() > arg ? std::stoi(tokens[arg]) : 16;
+            int threads = tokens.size() > arg + 1 ? std::stoi(tokens[arg + 1]) : 1;
+            searchBench(std::max(1, depth), maxNodes, std::max(1, hashMb), std::max(1, threads),
+                        tokens.size() > arg + 2 ? tokens[arg + 2] : "");
         }
     }
     